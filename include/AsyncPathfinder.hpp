@@ -0,0 +1,134 @@
+#ifndef __ASYNCPATHFINDER_H__
+#define __ASYNCPATHFINDER_H__
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <unordered_map>
+
+#include "Vector.hpp"
+#include "Pathfinder.hpp"
+#include "GridPathfinder.hpp"
+
+enum PathRequestStatus
+{
+    PATH_PENDING,
+    PATH_FOUND,
+    PATH_NOT_FOUND,
+    PATH_CANCELLED
+};
+
+/**
+ * Handle to a path search running on the AsyncPathfinder worker. Poll
+ * isReady() each tick, getPath() is only valid once the status is
+ * PATH_FOUND. While pending, takePartialPath() gives the path towards
+ * the closest point to the goal found so far, whenever it changes.
+ **/
+class PathRequest
+{
+public:
+    PathRequest(const Vector3f &start, const Vector3f &end,
+                const bool &diagonal, const PathSearch &search);
+
+    PathRequestStatus getStatus() const { return (PathRequestStatus)status_.load(std::memory_order_acquire); }
+    bool isReady() const { return getStatus() != PATH_PENDING; }
+    bool isFound() const { return getStatus() == PATH_FOUND; }
+
+    void cancel();
+
+    const std::deque<Vector3f> &getPath() const { return path_; }
+    // The grid cells behind getPath(), for caching the result
+    const std::vector<std::pair<int, int>> &getCells() const { return cells_; }
+
+    bool takePartialPath(std::deque<Vector3f> &out_path);
+
+private:
+    friend class AsyncPathfinder;
+
+    const void *owner_;
+    Vector3f start_;
+    Vector3f end_;
+    bool diagonal_;
+    PathSearch search_;
+
+    // Search settings copied from the source pathfinder
+    float heuristicWeight_;
+    bool smoothPath_;
+
+    // Snapshot of the obstacle grid taken when the request was made
+    Vector3f gridPosition_;
+    std::vector<int> grid_;
+
+    std::deque<Vector3f> path_;
+    std::vector<std::pair<int, int>> cells_;
+
+    std::mutex partialMutex_;
+    std::deque<Vector3f> partialPath_;
+    bool partialChanged_;
+
+    std::atomic<int> status_;
+
+    bool finish_(const PathRequestStatus &status);
+};
+
+/**
+ * Runs path searches on a worker thread. Each request searches a copy of
+ * the pathfinder's grid so the main thread can keep changing the world,
+ * and a newer request from the same owner cancels the older one.
+ **/
+class AsyncPathfinder
+{
+public:
+    AsyncPathfinder(const float &width, const float &height,
+                    const int &gridCols, const int &gridRows);
+    ~AsyncPathfinder();
+
+    std::shared_ptr<PathRequest> request(const void *owner,
+                                         const Pathfinder &source,
+                                         const Vector3f &start, const Vector3f &end,
+                                         const bool &diagonal,
+                                         const PathSearch &search = SEARCH_ASTAR);
+
+    void cancel(const void *owner);
+
+    // A request answered without searching, such as from a path cache. It
+    // replaces the owner's previous request like any other
+    std::shared_ptr<PathRequest> finished(const void *owner,
+                                          const Vector3f &start, const Vector3f &end,
+                                          const bool &diagonal,
+                                          const PathSearch &search,
+                                          const bool &found,
+                                          const std::deque<Vector3f> &path);
+
+    // Nodes expanded between checks for cancellation and partial paths
+    void setNodeBudget(const int &nodes) { nodeBudget_ = std::max(nodes, 1); }
+
+    // Owners with a request still pending. Owners are forgotten once their
+    // request finishes, or with cancel() when they go away
+    int getOwnerCount();
+
+private:
+    GridPathfinder pathfinder_; // Only used by the worker thread
+
+    std::deque<std::shared_ptr<PathRequest>> queue_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+    std::atomic<int> nodeBudget_;
+
+    // Guarded by mutex_, the worker drops requests as they finish
+    std::unordered_map<const void *, std::shared_ptr<PathRequest>> latest_;
+    // Guarded by mutex_, the request the worker is searching
+    std::shared_ptr<PathRequest> active_;
+
+    std::thread workerThread_;
+
+    void run_();
+    void forget_(const std::shared_ptr<PathRequest> &request);
+};
+
+#endif // __ASYNCPATHFINDER_H__
@@ -48,6 +48,10 @@ public:
     Vector3f projectGround(const Vector2f &point) const;
     Vector3f projectGround(const Vector2i &point) const;
 
+    // Screen space area shown by the window at the current zoom, grown to
+    // cover the whole window when it is rotated
+    FloatRect getViewRect() const;
+
 private:
     Vector3f position_;
     Vector3f origin_;
@@ -0,0 +1,88 @@
+#ifndef __CELLABSTRACTION_H__
+#define __CELLABSTRACTION_H__
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <limits>
+
+#include "ValueGrid.hpp"
+
+enum CellSide
+{
+    SIDE_TOP,    // j = 0
+    SIDE_RIGHT,  // i = cols - 1
+    SIDE_BOTTOM, // j = rows - 1
+    SIDE_LEFT    // i = 0
+};
+
+struct CellEntrance
+{
+    int i;
+    int j;
+    int side;
+};
+
+// A run of walkable cells along one side of a cell, [start, end)
+struct EntranceRun
+{
+    int start;
+    int end;
+    int entrance;
+};
+
+/**
+ * Abstract view of a single WorldCell used for hierarchical pathfinding.
+ * Every walkable run along each border of the obstacle grid gets one
+ * entrance in its middle, and the shortest distances between all
+ * entrances inside the cell are precomputed.
+ **/
+class CellAbstraction
+{
+public:
+    CellAbstraction();
+
+    void build(const ValueGrid<int> &grid, const int &validValue);
+
+    bool isBuilt() const { return built_; }
+    const int &getValidValue() const { return validValue_; }
+
+    const std::vector<CellEntrance> &getEntrances() const { return entrances_; }
+
+    // Infinity if the entrances are not connected inside the cell
+    float getDistance(const int &from, const int &to) const
+    {
+        return distances_[from * entrances_.size() + to];
+    }
+
+    // Index of the entrance whose run on side covers position, or -1
+    int findEntrance(const int &side, const int &position) const;
+
+    // Position of an entrance along its side
+    int sidePosition(const int &entrance) const;
+
+    // Walkable runs along a side, and the run an entrance sits in
+    const std::vector<EntranceRun> &getRuns(const int &side) const { return runs_[side]; }
+    const EntranceRun &getRun(const int &entrance) const;
+
+    static CellSide oppositeSide(const int &side);
+
+    // Dijkstra over the grid from (start_i, start_j), out is indexed by
+    // grid.index(i, j) and holds infinity for unreachable cells
+    static void distanceField(const ValueGrid<int> &grid, const int &validValue,
+                              const int &start_i, const int &start_j,
+                              std::vector<float> &out);
+
+private:
+    bool built_;
+    int validValue_;
+
+    std::vector<CellEntrance> entrances_;
+    std::vector<EntranceRun> runs_[4];
+    std::vector<float> distances_;
+
+    void addRuns_(const ValueGrid<int> &grid, const int &side);
+};
+
+#endif // __CELLABSTRACTION_H__
@@ -0,0 +1,42 @@
+#ifndef __CLEARANCEMAP_H__
+#define __CLEARANCEMAP_H__
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "ValueGrid.hpp"
+
+// Clearances are capped, agents are never this many cells across
+const int MAX_CLEARANCE = 8;
+
+/**
+ * Distance transform over a grid of walkable cells. The clearance of a
+ * cell is the chessboard distance to the nearest blocked cell, so a
+ * blocked cell has 0 and a square of 2 * c - 1 cells centred on a cell
+ * with clearance c is all walkable.
+ **/
+class ClearanceMap
+{
+public:
+    // Cells outside the grid count as blocked if edgeBlocked, otherwise
+    // as walkable so grids can be stitched together later
+    static void build(const std::vector<char> &walkable,
+                      const int &cols, const int &rows,
+                      const bool &edgeBlocked,
+                      std::vector<unsigned char> &out);
+
+    static void build(const ValueGrid<int> &grid, const int &validValue,
+                      std::vector<unsigned char> &out);
+
+    // Lower the clearances to account for blocked seed cells
+    static void lowerFrom(const std::vector<int> &seeds,
+                          const int &cols, const int &rows,
+                          std::vector<unsigned char> &clearance);
+
+    // Cells of clearance needed for an agent of the given size
+    static int needed(const float &size, const float &cellSize);
+};
+
+#endif // __CLEARANCEMAP_H__
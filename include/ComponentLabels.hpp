@@ -0,0 +1,27 @@
+#ifndef __COMPONENTLABELS_H__
+#define __COMPONENTLABELS_H__
+
+#include <iostream>
+#include <vector>
+
+#include "ValueGrid.hpp"
+
+/**
+ * Connected regions of walkable cells. Cells are joined to their four
+ * edge neighbours only, diagonal moves never cut corners so they cannot
+ * reach a cell that is not also reachable this way. Labels start at 1,
+ * blocked cells are 0.
+ **/
+class ComponentLabels
+{
+public:
+    // Returns the number of components
+    static int build(const std::vector<char> &walkable,
+                     const int &cols, const int &rows,
+                     std::vector<int> &out);
+
+    static int build(const ValueGrid<int> &grid, const int &validValue,
+                     std::vector<int> &out);
+};
+
+#endif // __COMPONENTLABELS_H__
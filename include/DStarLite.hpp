@@ -0,0 +1,87 @@
+#ifndef __DSTARLITE_H__
+#define __DSTARLITE_H__
+
+#include <vector>
+#include <set>
+#include <cmath>
+#include <limits>
+
+#include "Pathfinder.hpp"
+
+/**
+ * Incremental planner (D* Lite) over the cells of a Pathfinder. The
+ * search runs from the goal towards the start and its state is kept
+ * between calls to plan(), so when the start moves or a few cells change
+ * only the affected part of the search is repeated.
+ *
+ * Cells can also be blocked on top of the pathfinder's own grid, for
+ * things like entities that are not part of the obstacle grid.
+ **/
+class DStarLite
+{
+public:
+    DStarLite(const Pathfinder &pathfinder);
+
+    // Forget the search, needed when the pathfinder's grid moves
+    void reset();
+
+    bool plan(const int &start_i, const int &start_j,
+              const int &goal_i, const int &goal_j,
+              std::vector<std::pair<int, int>> &resultPath);
+
+    // Cells whose value changed since the last plan(). Planning with an
+    // agent clearance above 1, a change also decides whether the cells
+    // within clearance - 1 of it are passable, so those are replanned too
+    void updateCells(const std::vector<std::pair<int, int>> &cells,
+                     const int &clearance = 1);
+
+    void setBlocked(const int &i, const int &j, const bool &blocked);
+    void clearBlocked();
+
+    // Blocks exactly these cells, only the ones that changed are replanned
+    void setBlockedCells(const std::vector<std::pair<int, int>> &cells);
+
+    // Passable in the pathfinder with its current agent clearance, which
+    // must stay the same until reset(), and not blocked here
+    bool validCell(const int &i, const int &j) const;
+
+    bool hasGoal() const { return goal_ >= 0; }
+
+    const int &getRuns() const { return runs_; }
+
+private:
+    typedef std::pair<float, float> Key;
+
+    const Pathfinder *pathfinder_;
+    int cols_;
+    int rows_;
+
+    int start_;
+    int last_;
+    int goal_;
+    float km_;
+
+    int runs_;
+
+    std::vector<float> g_;
+    std::vector<float> rhs_;
+    std::vector<char> blocked_;
+
+    std::vector<Key> queuedKey_;
+    std::vector<char> queued_;
+    std::set<std::pair<Key, int>> queue_;
+
+    std::vector<int> pending_;
+
+    void initialize_(const int &start, const int &goal);
+    Key calculateKey_(const int &cell) const;
+    bool keyBefore_(const Key &a, const Key &b) const;
+    void updateVertex_(const int &cell);
+    void updateRhs_(const int &cell);
+    void computeShortestPath_();
+
+    float cost_(const int &from, const int &to) const;
+    float heuristic_(const int &a, const int &b) const;
+};
+
+#endif // __DSTARLITE_H__
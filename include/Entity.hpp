@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <SFML/Graphics.hpp>
 
 #include "Vector.hpp"
@@ -23,8 +24,16 @@ public:
     virtual void transform(Camera &camera);
     virtual void draw(sf::RenderTarget *screen);
 
+    // Area the entity covers on screen, used to skip off screen entities
+    // before they are transformed
+    virtual FloatRect getScreenBounds(const Camera &camera) const;
+
     virtual void drawReflection(sf::RenderTarget *screen){};
 
+    // Entities built off the main thread make their textures here, on the
+    // main thread only
+    virtual void uploadTexture(){};
+
     virtual void attack(){};
 
     Vector3f getPosition() const;
@@ -0,0 +1,59 @@
+#ifndef __FLOWFIELD_H__
+#define __FLOWFIELD_H__
+
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <limits>
+
+#include "Vector.hpp"
+#include "Pathfinder.hpp"
+
+/**
+ * Directions towards one goal for every cell of a Pathfinder. Built with
+ * a single Dijkstra pass from the goal, after which any number of
+ * entities can look up where to go next in constant time. Only cells
+ * passable with the pathfinder's agent clearance at build time are used.
+ **/
+class FlowField
+{
+public:
+    FlowField(const Pathfinder &pathfinder);
+
+    void build(const int &goal_i, const int &goal_j);
+
+    const int &getGoali() const { return goal_i_; }
+    const int &getGoalj() const { return goal_j_; }
+
+    // Path cost from the cell to the goal, infinity if it is unreachable
+    float cost(const int &i, const int &j) const;
+    bool reachable(const int &i, const int &j) const;
+
+    // Next cell on the way to the goal, false at the goal or if unreachable
+    bool next(const int &i, const int &j, int &out_i, int &out_j) const;
+
+    // Unit direction to walk from a point, zero at the goal or if unreachable
+    Vector3f direction(const Vector3f &point) const;
+
+    const int &getRuns() const { return runs_; }
+
+private:
+    const Pathfinder *pathfinder_;
+    int cols_;
+    int rows_;
+
+    int goal_i_;
+    int goal_j_;
+
+    int runs_;
+
+    std::vector<float> costs_;
+    std::vector<char> directions_; // Neighbour offset (ci + 1) + 3 * (cj + 1), -1 if none
+
+    Vector3f unitDirections_[9];
+
+    void integrate_();
+    void buildDirections_();
+};
+
+#endif // __FLOWFIELD_H__
@@ -22,6 +22,10 @@ public:
     virtual bool validIndex(const int &i, const int &j) const;
     virtual bool validCell(const int &i, const int &j) const;
 
+    // Clearances are computed on request and dropped when the grid changes
+    void buildClearance();
+    virtual int clearance(const int &i, const int &j) const;
+
     void printGrid(const int &start_i, const int &start_j,
                    const int &end_i, const int &end_j,
                    const std::vector<std::pair<int, int>> &resultPath) const;
@@ -31,6 +35,7 @@ public:
 
 private:
     std::vector<int> grid_;
+    std::vector<unsigned char> clearance_;
 
     int active_cols_;
     int active_rows_;
@@ -23,6 +23,15 @@ public:
     virtual void transform(Camera &camera);
     virtual void draw(sf::RenderTarget *screen);
 
+    virtual FloatRect getScreenBounds(const Camera &camera) const;
+
+    // The floor is baked into an image by the constructor, which can run
+    // on any thread. The texture is made from it here, on the main thread
+    virtual void uploadTexture();
+
+    // Video memory held by the baked floor texture
+    std::size_t getTextureBytes() const;
+
 private:
     float width_;
     float height_;
@@ -34,6 +43,7 @@ private:
     Vector2f i_hat;
     Vector2f j_hat;
 
+    sf::Image floorImage_;
     sf::Texture floor_;
 
     sf::VertexArray floorShape_;
@@ -49,6 +59,8 @@ public:
     virtual void transform(Camera &camera);
     virtual void draw(sf::RenderTarget *screen);
 
+    virtual FloatRect getScreenBounds(const Camera &camera) const;
+
 private:
     int cols_;
     int rows_;
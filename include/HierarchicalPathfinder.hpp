@@ -0,0 +1,70 @@
+#ifndef __HIERARCHICALPATHFINDER_H__
+#define __HIERARCHICALPATHFINDER_H__
+
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Vector.hpp"
+#include "WorldConfig.hpp"
+#include "WorldCell.hpp"
+#include "CellAbstraction.hpp"
+
+/**
+ * Searches the abstract graph formed by the border entrances of every
+ * loaded WorldCell (HPA*). Coordinates are global sub cell coordinates,
+ * cell_i * subCols + local_i, so paths can leave the active 3x3 window.
+ * The result is a list of entrance cells that still has to be refined
+ * with a regular grid search.
+ **/
+class HierarchicalPathfinder
+{
+public:
+    HierarchicalPathfinder(WorldConfig &worldConfig,
+                           std::unordered_map<int, WorldCell *> &cells);
+
+    bool findPath(const Vector3f &start, const Vector3f &end,
+                  std::vector<std::pair<int, int>> &resultPath);
+
+    bool searchAbstract(const int &start_i, const int &start_j,
+                        const int &end_i, const int &end_j,
+                        std::vector<std::pair<int, int>> &resultPath);
+
+    void toGridCoord(const Vector3f &point, int &out_i, int &out_j) const;
+    Vector3f toPoint(const int &i, const int &j) const;
+
+    const int &getRuns() const { return runs_; }
+
+private:
+    WorldConfig *worldConfig_;
+    std::unordered_map<int, WorldCell *> *cells_;
+
+    int runs_;
+
+    struct AbstractNode
+    {
+        int i, j;
+        float g;
+        int64_t parent;
+        bool closed;
+    };
+
+    std::unordered_map<int64_t, AbstractNode> nodes_;
+
+    typedef std::pair<float, int64_t> QueueItem;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> openQueue_;
+
+    std::vector<float> startField_;
+    std::vector<float> endField_;
+
+    const CellAbstraction *abstraction_(const int &cell_i, const int &cell_j, WorldCell **outCell = nullptr) const;
+
+    int64_t key_(const int &cell_i, const int &cell_j, const int &entrance) const;
+
+    void visit_(const int64_t &key, const int64_t &parent,
+                const int &i, const int &j, const float &g,
+                const int &end_i, const int &end_j);
+};
+
+#endif // __HIERARCHICALPATHFINDER_H__
@@ -21,6 +21,7 @@ public:
     virtual void update(sf::Time &elapsed, World &world);
     virtual void transform(Camera &camera);
     virtual void draw(sf::RenderTarget *screen);
+    virtual FloatRect getScreenBounds(const Camera &camera) const;
 
     virtual void attack(); // World &world, Player &player);
 
@@ -0,0 +1,76 @@
+#ifndef __JOBPOOL_H__
+#define __JOBPOOL_H__
+
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+enum JobStatus
+{
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_DONE,
+    JOB_CANCELLED
+};
+
+class Job
+{
+public:
+    JobStatus getStatus() const { return (JobStatus)status_.load(std::memory_order_acquire); }
+    bool isFinished() const { return getStatus() == JOB_DONE || getStatus() == JOB_CANCELLED; }
+
+private:
+    friend class JobPool;
+
+    std::function<void()> work_;
+    int priority_;
+    unsigned long order_;
+
+    std::atomic<int> status_;
+};
+
+/**
+ * Fixed number of worker threads running submitted jobs. The queued job
+ * with the lowest priority value runs next, oldest first among equals.
+ * Queued jobs can be reprioritised or cancelled, running ones always
+ * finish.
+ **/
+class JobPool
+{
+public:
+    // Sized to the hardware concurrency when threads < 1
+    JobPool(const int &threads = 0);
+    ~JobPool();
+
+    std::shared_ptr<Job> submit(const std::function<void()> &work, const int &priority);
+
+    void setPriority(const std::shared_ptr<Job> &job, const int &priority);
+
+    // True if the job will not run, false if it is running or already done
+    bool cancel(const std::shared_ptr<Job> &job);
+
+    // Block until the job is done or cancelled
+    void wait(const std::shared_ptr<Job> &job);
+
+    int getThreadCount() const { return workers_.size(); }
+    int getQueuedCount();
+
+private:
+    std::vector<std::thread> workers_;
+
+    std::vector<std::shared_ptr<Job>> queue_;
+    unsigned long nextOrder_;
+    std::mutex mutex_;
+    std::condition_variable jobQueued_;
+    std::condition_variable jobFinished_;
+    bool stopping_;
+
+    void run_();
+};
+
+#endif // __JOBPOOL_H__
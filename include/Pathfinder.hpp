@@ -7,27 +7,48 @@
 #include <queue>
 #include <deque>
 #include <cstring>
+#include <limits>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <atomic>
 
 #include "Vector.hpp"
 #include "Entity.hpp"
 #include "Algorithm.hpp"
+#include "ClearanceMap.hpp"
+#include "JobPool.hpp"
 
 const int ZERO = 0;
 const int ONE = 1;
 
+enum PathSearch
+{
+    SEARCH_ASTAR,
+    SEARCH_JPS // Jump Point Search, only used for diagonal searches
+};
+
+enum SearchStatus
+{
+    SEARCH_IN_PROGRESS,
+    SEARCH_FOUND,
+    SEARCH_NOT_FOUND
+};
+
 class Node
 {
 public:
-    Node() : parent(nullptr){};
+    Node() : parent(nullptr), heapIndex(-1){};
     Node(const int &I, const int &J,
          const float &G, const float &H, const float &F,
-         Node *Parent) : i(I), j(J), g(G), h(H), f(F), parent(Parent){};
+         Node *Parent) : i(I), j(J), g(G), h(H), f(F), parent(Parent), heapIndex(-1){};
     int i;
     int j;
     float g;
     float h;
     float f;
     Node *parent;
+    int heapIndex; // Position in NodeHeap, -1 when not queued
 };
 
 struct MoreThanByF
@@ -38,6 +59,164 @@ struct MoreThanByF
     }
 };
 
+// Binary min-heap on f that tracks the position of each node, so a node
+// whose f drops can be moved up in place instead of being pushed again
+class NodeHeap
+{
+public:
+    bool empty() const { return heap_.empty(); }
+    int size() const { return heap_.size(); }
+
+    void reserve(const int &capacity) { heap_.reserve(capacity); }
+
+    void clear()
+    {
+        for (auto &node : heap_)
+            node->heapIndex = -1;
+        heap_.clear();
+    }
+
+    Node *top() const { return heap_.front(); }
+
+    void push(Node *node)
+    {
+        node->heapIndex = heap_.size();
+        heap_.push_back(node);
+        siftUp_(node->heapIndex);
+    }
+
+    Node *pop()
+    {
+        Node *result = heap_.front();
+        result->heapIndex = -1;
+
+        Node *last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty())
+        {
+            heap_[0] = last;
+            last->heapIndex = 0;
+            siftDown_(0);
+        }
+
+        return result;
+    }
+
+    // Call after lowering node->f
+    void decreaseKey(Node *node)
+    {
+        if (node->heapIndex < 0)
+        {
+            push(node);
+            return;
+        }
+        siftUp_(node->heapIndex);
+    }
+
+private:
+    std::vector<Node *> heap_;
+
+    void siftUp_(int index)
+    {
+        Node *node = heap_[index];
+        while (index > 0)
+        {
+            int parent = (index - 1) / 2;
+            if (!(heap_[parent]->f > node->f))
+                break;
+            heap_[index] = heap_[parent];
+            heap_[index]->heapIndex = index;
+            index = parent;
+        }
+        heap_[index] = node;
+        node->heapIndex = index;
+    }
+
+    void siftDown_(int index)
+    {
+        int count = heap_.size();
+        Node *node = heap_[index];
+        while (true)
+        {
+            int child = index * 2 + 1;
+            if (child >= count)
+                break;
+            if (child + 1 < count && heap_[child]->f > heap_[child + 1]->f)
+                child += 1;
+            if (!(node->f > heap_[child]->f))
+                break;
+            heap_[index] = heap_[child];
+            heap_[index]->heapIndex = index;
+            index = child;
+        }
+        heap_[index] = node;
+        node->heapIndex = index;
+    }
+};
+
+// Everything a single search writes to. Searches only read the grid, so
+// searches with their own scratch can run on different threads
+class SearchScratch
+{
+public:
+    SearchScratch() : runs(0), nodesUsed(0), reusedNodes(0), nodePoolUsed(0), generation(0),
+                      end_i(0), end_j(0), diagonal(false), jps(false),
+                      bestNode(nullptr), goalNode(nullptr){};
+
+    int runs;
+    int nodesUsed;
+    int reusedNodes;
+
+    // Nodes are handed out from a pool sized to the grid, every cell gets
+    // at most one node per search so the pool never has to grow
+    std::vector<Node> nodePool;
+    int nodePoolUsed;
+
+    // Open and closed sets are flat arrays indexed by cell. A cell belongs
+    // to a set only if its stamp matches the current search generation, so
+    // starting a new search just bumps the generation
+    unsigned int generation;
+
+    std::vector<Node *> openList;
+    std::vector<unsigned int> openStamp;
+
+    std::vector<unsigned int> closedStamp;
+
+    NodeHeap openQueue;
+
+    // The search in progress, kept here so it can be resumed
+    int end_i;
+    int end_j;
+    bool diagonal;
+    bool jps;
+    Node *bestNode; // Closed node with the lowest h
+    Node *goalNode;
+
+    bool isOpen(const int &index) const { return openStamp[index] == generation; }
+    bool isClosed(const int &index) const { return closedStamp[index] == generation; }
+
+    Node *newNode(const int &I, const int &J,
+                  const float &G, const float &H, const float &F,
+                  Node *Parent);
+    void reset(const int &cells);
+    void cleanUp();
+};
+
+struct PathQuery
+{
+    int start_i;
+    int start_j;
+    int end_i;
+    int end_j;
+};
+
+struct PathQueryResult
+{
+    bool found;
+    int runs;
+    std::vector<std::pair<int, int>> path;
+};
+
 class Pathfinder
 {
 public:
@@ -49,24 +228,111 @@ public:
     void setPosition(const Vector3f &position) { position_ = position; }
     const Vector3f &getPosition() const { return position_; }
 
-    bool isAreaFree(const Vector3f &localPosition, const Vector3f &size) const;
+    virtual bool isAreaFree(const Vector3f &localPosition, const Vector3f &size) const;
     bool findFreeCell(const Vector3f &position, const int &maxDiameter, int &out_i, int &out_j) const;
     bool findFreePosition(const Vector3f &position, const int &maxDiameter, Vector3f &out_position) const;
 
     bool findPath(const Vector3f &start, const Vector3f &end,
                   const bool &diagonal,
-                  std::deque<Vector3f> &resultPath);
+                  std::deque<Vector3f> &resultPath,
+                  const PathSearch &search = SEARCH_ASTAR);
 
     bool searchAStar(const int &start_i, const int &start_j,
                      const int &end_i, const int &end_j,
                      const bool &diagonal,
                      std::vector<std::pair<int, int>> &resultPath);
 
+    bool searchJPS(const int &start_i, const int &start_j,
+                   const int &end_i, const int &end_j,
+                   std::vector<std::pair<int, int>> &resultPath);
+
+    // Points to walk through for a path of cells, smoothed if enabled,
+    // without the first cell where the walker already is
+    void toPath(const std::vector<std::pair<int, int>> &cells,
+                std::deque<Vector3f> &resultPath) const;
+
     const std::vector<std::pair<int, int>> &getLastResultPath() const { return resultPathCells_; }
 
-    const int &getRuns() const { return runs_; }
-    const int &getNodesUsed() const { return nodesUsed_; }
-    const int &getNodesReused() const { return reusedNodes_; }
+    // Weighted A*, h is scaled by weight. Paths found are at most weight
+    // times longer than the shortest path, in exchange for fewer expansions
+    void setHeuristicWeight(const float &weight) { heuristicWeight_ = std::max(weight, 1.f); }
+    const float &getHeuristicWeight() const { return heuristicWeight_; }
+
+    // Drop waypoints from findPath results wherever the next one is in
+    // line of sight, the cells in getLastResultPath() are left untouched
+    void setSmoothPath(const bool &smooth) { smoothPath_ = smooth; }
+    const bool &getSmoothPath() const { return smoothPath_; }
+
+    // Searches only pass through cells with at least this clearance, see
+    // ClearanceMap. 1 plans for a point
+    void setAgentClearance(const int &clearance) { agentClearance_ = std::max(clearance, 1); }
+    const int &getAgentClearance() const { return agentClearance_; }
+
+    bool passableCell(const int &i, const int &j) const
+    {
+        if (agentClearance_ < 2)
+            return validCell(i, j);
+        return clearance(i, j) >= agentClearance_;
+    }
+
+    // Cost of a step from the cell to the neighbour (ci, cj) away, 1 straight
+    // and sqrt(2) diagonally. Infinity into a cell that is not passable, or
+    // diagonally past one, which would cut its corner. Every planner over a
+    // Pathfinder steps by this rule
+    float stepCost(const int &i, const int &j, const int &ci, const int &cj) const
+    {
+        return stepCost(i, j, ci, cj, [this](const int &a, const int &b)
+                        { return passableCell(a, b); });
+    }
+
+    // The same rule with other cells counted as passable
+    template <typename Passable>
+    static float stepCost(const int &i, const int &j, const int &ci, const int &cj,
+                          const Passable &passable)
+    {
+        if (!passable(i + ci, j + cj))
+            return std::numeric_limits<float>::infinity();
+
+        if (ci == 0 || cj == 0)
+            return 1.f;
+
+        if (!(passable(i + ci, j) && passable(i, j + cj)))
+            return std::numeric_limits<float>::infinity();
+
+        return M_SQRT2;
+    }
+
+    bool lineOfSight(const int &start_i, const int &start_j,
+                     const int &end_i, const int &end_j) const;
+
+    void smoothPath(const std::vector<std::pair<int, int>> &path,
+                    std::vector<std::pair<int, int>> &resultPath) const;
+
+    // Resumable search, each continueSearch() expands at most nodeBudget
+    // nodes. Until it is found getSearchPath() gives the path to the
+    // closest node to the goal so far. Uses its own scratch, so findPath
+    // can be used while a resumable search is in progress
+    bool beginSearch(const int &start_i, const int &start_j,
+                     const int &end_i, const int &end_j,
+                     const bool &diagonal,
+                     const PathSearch &search = SEARCH_ASTAR);
+    const SearchStatus &continueSearch(const int &nodeBudget);
+    const SearchStatus &getSearchStatus() const { return searchStatus_; }
+    void getSearchPath(std::vector<std::pair<int, int>> &resultPath) const;
+    const int &getSearchRuns() const { return resumable_.runs; }
+
+    // Runs all queries spread over worker threads, each with its own
+    // scratch. The workers and scratch are kept between batches. Paths are
+    // smoothed like findPath's
+    void findPaths(const std::vector<PathQuery> &queries,
+                   const bool &diagonal,
+                   std::vector<PathQueryResult> &results,
+                   const PathSearch &search = SEARCH_ASTAR,
+                   const int &threads = 0);
+
+    const int &getRuns() const { return scratch_.runs; }
+    const int &getNodesUsed() const { return scratch_.nodesUsed; }
+    const int &getNodesReused() const { return scratch_.reusedNodes; }
 
     void toGridCoord(const Vector3f &point, int &out_i, int &out_j) const;
     void toLocalGridCoord(const Vector3f &localPoint, int &out_i, int &out_j) const;
@@ -91,6 +357,32 @@ public:
     virtual bool validCell(const int &i, const int &j) const = 0;
     virtual const int &cellValue(const int &i, const int &j) const = 0;
 
+    // Without a clearance map every valid cell counts as wide open
+    virtual int clearance(const int &i, const int &j) const;
+
+    // Whether both cells could be connected at all. Without component
+    // labels every pair might be, findPath skips the search when not
+    virtual bool sameComponent(const int &, const int &,
+                               const int &, const int &) const { return true; }
+    bool sameComponent(const Vector3f &a, const Vector3f &b) const;
+
+    // Whether all / any of the cells start_i <= i < end_i on row j are
+    // valid. Checks cell by cell, grids with packed rows can do better
+    virtual bool rowFree(const int &j, const int &start_i, const int &end_i) const;
+    virtual bool rowHasFree(const int &j, const int &start_i, const int &end_i) const;
+
+protected:
+    // For answers given without searching, getRuns() and getNodesUsed()
+    // then report no work instead of the previous search's
+    void clearSearchStats_();
+
+    // The cell search behind findPath, children can put a cache in front
+    virtual bool searchCells_(const int &start_i, const int &start_j,
+                              const int &end_i, const int &end_j,
+                              const bool &diagonal,
+                              const PathSearch &search,
+                              std::vector<std::pair<int, int>> &resultPath);
+
 private:
     Vector3f position_;
     float width_;
@@ -101,26 +393,51 @@ private:
     float cellWidth_;
     float cellHeight_;
 
-    int runs_;
-    int nodesUsed_;
-    int reusedNodes_;
+    float heuristicWeight_;
+    bool smoothPath_;
+    int agentClearance_;
+
 
     std::vector<std::pair<int, int>> resultPathCells_;
 
-    std::vector<Node *> nodeList_;
+    SearchScratch scratch_;
+    std::vector<SearchScratch> batchScratch_;
+    std::unique_ptr<JobPool> batchPool_; // Made on the first batch, kept after
 
-    std::unordered_map<int, Node *> openList_;
+    SearchScratch resumable_;
+    SearchStatus searchStatus_;
 
-    std::unordered_map<int, bool> closedList_;
+    bool validAdjacent_(const int &i, const int &j, const int &center_i, const int &center_j, const bool &diagonal) const;
 
-    std::priority_queue<Node *, std::vector<Node *>, MoreThanByF> openQueue_;
+    float heuristic_(const int &i, const int &j, const int &end_i, const int &end_j, const bool &diagonal) const;
 
-    Node *newNode(const int &I, const int &J,
-                  const float &G, const float &H, const float &F,
-                  Node *Parent);
-    void cleanUp();
+    bool searchAStar_(const int &start_i, const int &start_j,
+                      const int &end_i, const int &end_j,
+                      const bool &diagonal,
+                      std::vector<std::pair<int, int>> &resultPath,
+                      SearchScratch &scratch) const;
 
-    bool validAdjacent_(const int &i, const int &j, const int &center_i, const int &center_j, const bool &diagonal) const;
+    bool searchJPS_(const int &start_i, const int &start_j,
+                    const int &end_i, const int &end_j,
+                    std::vector<std::pair<int, int>> &resultPath,
+                    SearchScratch &scratch) const;
+
+    bool startSearch_(const int &start_i, const int &start_j,
+                      const int &end_i, const int &end_j,
+                      const bool &diagonal,
+                      const PathSearch &search,
+                      SearchScratch &scratch) const;
+    SearchStatus stepSearch_(const int &nodeBudget, SearchScratch &scratch) const;
+    void expandAStar_(Node *currentNode, SearchScratch &scratch) const;
+    void expandJPS_(Node *currentNode, SearchScratch &scratch) const;
+    void buildPath_(const Node *node, std::vector<std::pair<int, int>> &resultPath) const;
+
+    bool jump_(int i, int j, const int &d_i, const int &d_j,
+               const int &end_i, const int &end_j,
+               int &out_i, int &out_j) const;
+    void addJumpSuccessor_(Node *parent, const int &d_i, const int &d_j,
+                           const int &end_i, const int &end_j,
+                           SearchScratch &scratch) const;
 };
 
 #endif // __PATHFINDER_H__
\ No newline at end of file
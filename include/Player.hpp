@@ -4,11 +4,13 @@
 #include <string>
 #include <deque>
 #include <cmath>
+#include <memory>
 
 #include "Vector.hpp"
 #include "AnimatedEntity.hpp"
 #include "ResourceManager.hpp"
 #include "StateMachine2.hpp"
+#include "AsyncPathfinder.hpp"
 #include "World.hpp"
 
 DEFINE_STATE_EVENTS(Player,
@@ -42,6 +44,10 @@ public:
 
     void setInWater(bool in);
 
+    // Where the player is headed, the world loads cells ahead of it
+    const Vector3f &getVelocity() const { return velocity_; }
+    const std::deque<Vector3f> &getWalkPath() const { return walkPath_; }
+
 private:
     float walkSpeed_ = 1.f;
 
@@ -51,6 +57,8 @@ private:
 
     bool inWater = false;
 
+    Vector3f velocity_;
+
     enum StateEvent
     {
         WALK_TO_TARGET,
@@ -69,6 +77,8 @@ private:
 
     Vector3f walkTarget_;
     std::deque<Vector3f> walkPath_;
+    std::shared_ptr<PathRequest> pathRequest_;
+    int repairs_ = 0; // Since the walk started
 
     std::string animationDirection_;
     std::string animationAction_;
@@ -15,8 +15,6 @@ public:
     ResourceType *load(const std::string &filename);
 
 private:
-    ResourceType *insert_(const std::string &filename, ResourceType *addTexture);
-
     std::unordered_map<std::string, ResourceType *> resources_;
     std::mutex mutex_;
 };
@@ -36,6 +34,10 @@ ResourceCache<ResourceType>::~ResourceCache()
 template <class ResourceType>
 ResourceType *ResourceCache<ResourceType>::load(const std::string &filename)
 {
+    // Cells load on the job pool, held for the whole load so no thread
+    // reads the map while another inserts into it
+    std::lock_guard<std::mutex> lock(mutex_);
+
     auto search = resources_.find(filename);
 
     if (search != resources_.end())
@@ -49,28 +51,12 @@ ResourceType *ResourceCache<ResourceType>::load(const std::string &filename)
     {
         delete newResource;
         // Mark as invalid texture source
-        return insert_(filename, nullptr);
-    }
-
-    return insert_(filename, newResource);
-}
-
-template <class ResourceType>
-ResourceType *ResourceCache<ResourceType>::insert_(const std::string &filename, ResourceType *addResource)
-{
-    // Insert texture to cache in a thread safe manner
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto search = resources_.find(filename);
-
-    if (search != resources_.end())
-    {
-        return search->second;
+        newResource = nullptr;
     }
 
-    resources_[filename] = addResource;
+    resources_[filename] = newResource;
 
-    return addResource;
+    return newResource;
 }
 
 #endif // __RESOURCECACHE_H__
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef __SPATIALHASH_H__
+#define __SPATIALHASH_H__
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+
+#include "Vector.hpp"
+#include "Entity.hpp"
+
+/**
+ * Uniform grid of buckets over the x-y plane, keyed by each entity's local
+ * position. An entity lives in the bucket holding its center, queries look
+ * in the buckets around the query area padded by the largest entity's
+ * half size, then test the footprints exactly. Every entity in the hash
+ * must share the same origin.
+ **/
+class SpatialHash
+{
+public:
+    SpatialHash(const float &bucketSize);
+
+    void insert(Entity *entity);
+    void remove(Entity *entity);
+
+    // Moves the entity to its current bucket, call after it moves
+    void update(Entity *entity);
+
+    void clear();
+
+    bool contains(Entity *entity) const { return buckets_.count(entity) > 0; }
+    int getCount() const { return buckets_.size(); }
+
+    // Entities whose footprint overlaps the rectangle of size centered on
+    // localPoint, the results are appended to out_entities
+    void queryRect(const Vector3f &localPoint, const Vector3f &size,
+                   std::vector<Entity *> &out_entities) const;
+
+    // Entities whose size radius reaches within radius of localPoint
+    void queryRadius(const Vector3f &localPoint, const float &radius,
+                     std::vector<Entity *> &out_entities) const;
+
+private:
+    float bucketSize_;
+    float maxHalfSize_;
+
+    std::unordered_map<long long, std::vector<Entity *>> grid_;
+    std::unordered_map<Entity *, long long> buckets_; // Bucket of each entity
+
+    int toBucket_(const float &x) const { return (int)std::floor(x / bucketSize_); }
+    long long key_(const int &i, const int &j) const { return ((long long)i << 32) | (unsigned int)j; }
+    long long key_(const Vector3f &localPoint) const;
+
+    void unlink_(Entity *entity, const long long &key);
+
+    template <typename Test>
+    void query_(const Vector3f &localPoint, const float &halfWidth, const float &halfHeight,
+                std::vector<Entity *> &out_entities, Test test) const;
+};
+
+#endif // __SPATIALHASH_H__
@@ -17,6 +17,8 @@ public:
     virtual void transform(Camera &camera);
     virtual void draw(sf::RenderTarget *screen);
 
+    virtual FloatRect getScreenBounds(const Camera &camera) const;
+
     virtual void drawReflection(sf::RenderTarget *screen);
 
     void setTexture(sf::Texture *texture);
@@ -30,12 +32,18 @@ public:
 
     FloatRect getSpriteRect() const;
 
-    bool loadSprite(std::string filename);
+    // Reads the sprite file, with the texture unless deferTexture. Deferred
+    // sprites can be loaded on any thread, uploadTexture() sets the
+    // texture later
+    bool loadSprite(std::string filename, const bool &deferTexture = false);
+
+    virtual void uploadTexture();
 
 private:
     sf::Sprite sprite_;
     sf::Transform transform_;
     Vector2f spriteOrigin_;
+    std::string textureFile_; // Texture still to be set by uploadTexture()
 };
 
 #endif // __SPRITEENTITY_H__
\ No newline at end of file
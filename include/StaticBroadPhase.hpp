@@ -0,0 +1,54 @@
+#ifndef __STATICBROADPHASE_H__
+#define __STATICBROADPHASE_H__
+
+#include <vector>
+#include <algorithm>
+
+#include "Vector.hpp"
+#include "Entity.hpp"
+
+/**
+ * Footprints of entities that never move, sorted by their left edge. A
+ * query binary searches the strip of footprints that can reach it along x
+ * and only tests those, so it costs O(log n) plus the strip rather than a
+ * scan of every entity. Positions are each entity's local position, the
+ * entities must share an origin. Build once, then query from any thread.
+ **/
+class StaticBroadPhase
+{
+public:
+    StaticBroadPhase();
+
+    void build(const std::vector<Entity *> &entities);
+    void clear();
+
+    int getCount() const { return boxes_.size(); }
+    std::size_t getBytes() const { return boxes_.capacity() * sizeof(Box); }
+
+    // Entities whose footprint overlaps the rectangle of size centered on
+    // localPoint, the results are appended to out_entities
+    void queryRect(const Vector3f &localPoint, const Vector3f &size,
+                   std::vector<Entity *> &out_entities) const;
+
+    // Entities whose size radius reaches within radius of localPoint
+    void queryRadius(const Vector3f &localPoint, const float &radius,
+                     std::vector<Entity *> &out_entities) const;
+
+private:
+    struct Box
+    {
+        float left, right, top, bottom;
+        Entity *entity;
+    };
+
+    std::vector<Box> boxes_; // By left edge
+    float maxWidth_;
+    float maxRadius_;
+    Box bounds_; // Around all the boxes
+
+    template <typename Test>
+    void query_(const float &left, const float &right, const float &top, const float &bottom,
+                std::vector<Entity *> &out_entities, Test test) const;
+};
+
+#endif // __STATICBROADPHASE_H__
@@ -2,12 +2,13 @@
 #define __VALUEGRID_H__
 
 #include <vector>
+#include <utility>
 
 template <typename CellType>
 class ValueGrid
 {
 public:
-    ValueGrid(const int &cols, const int &rows) : cols_(cols), rows_(rows)
+    ValueGrid(const int &cols, const int &rows) : cols_(cols), rows_(rows), trackChanges_(false)
     {
         grid_.resize(cols_ * rows_);
     }
@@ -42,7 +43,10 @@ public:
 
         int ind = index(i, j);
 
-        grid_[index(i, j)] = value;
+        if (trackChanges_ && grid_[ind] != value)
+            changes_.push_back(std::pair<int, int>(i, j));
+
+        grid_[ind] = value;
     }
 
     void fill(const int &start_i, const int &start_j,
@@ -66,9 +70,25 @@ public:
     const int &rows() const { return rows_; }
     const int &cols() const { return cols_; }
 
+    // Record the cells changed by set() and fill(), for incremental planners
+    void trackChanges(const bool &track)
+    {
+        trackChanges_ = track;
+        changes_.clear();
+    }
+
+    void takeChanges(std::vector<std::pair<int, int>> &out)
+    {
+        out.insert(out.end(), changes_.begin(), changes_.end());
+        changes_.clear();
+    }
+
 private:
     int cols_, rows_;
     std::vector<CellType> grid_;
+
+    bool trackChanges_;
+    std::vector<std::pair<int, int>> changes_;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const ValueGrid<int> &v)
@@ -19,8 +19,12 @@
 #include "WorldConfig.hpp"
 #include "WorldCell.hpp"
 #include "WorldPathfinder.hpp"
+#include "HierarchicalPathfinder.hpp"
+#include "AsyncPathfinder.hpp"
+#include "DStarLite.hpp"
 #include "Ocean.hpp"
 #include "Interactable.hpp"
+#include "SpatialHash.hpp"
 
 class Player;
 
@@ -35,6 +39,8 @@ public:
     void draw(sf::RenderTarget *screen);
 
     Entity *addEntity(Entity *entity);
+    // Does not delete the entity
+    void removeEntity(Entity *entity);
     const std::vector<Entity *> &getEntitys() const;
 
     void onMouseButtonReleased(const sf::Event &event);
@@ -43,43 +49,139 @@ public:
 
     bool findPath(const Entity &entity, const Vector3f &end,
                   const bool &diagonal,
-                  std::deque<Vector3f> &resultPath);
+                  std::deque<Vector3f> &resultPath,
+                  const PathSearch &search = SEARCH_ASTAR);
+
+    // Runs the search on a worker thread, poll the returned handle. A new
+    // request for the same entity cancels its previous one
+    std::shared_ptr<PathRequest> requestPath(const Entity &entity, const Vector3f &end,
+                                             const bool &diagonal,
+                                             const PathSearch &search = SEARCH_ASTAR);
+
+    // Plans around the other entities and the point it could not step
+    // into when the entity is blocked on its path, reusing the previous
+    // repair's search where it can
+    bool repairPath(const Entity &entity, const Vector3f &end,
+                    const Vector3f &blocked,
+                    std::deque<Vector3f> &resultPath);
+
+    // Direction to walk towards the goal, read from a flow field shared
+    // by all entities with the same goal cell. Zero if there is no way
+    Vector3f flowDirection(const Entity &entity, const Vector3f &goal);
+
+    bool sameGridCell(const Vector3f &a, const Vector3f &b) const;
 
     bool canMoveTo(const Entity &entity, const Vector3f &localPoint) const;
 
+    // Entities whose footprint overlaps the rectangle of size centered on
+    // the global point, from entities_ and the trees of the active cells
+    void queryEntities(const Vector3f &point, const Vector3f &size,
+                       std::vector<Entity *> &out_entities) const;
+
     bool findNearbyFreePosition(const Vector3f &position, Vector3f &out_position);
 
     bool saveState(std::string path);
     bool loadState(std::string path);
     void loadDefault();
 
+    // Least recently used cells outside the active ones are deleted once
+    // the loaded cells hold more than this many bytes
+    void setCellCacheBudget(const std::size_t &bytes);
+    std::size_t getCellCacheBytes() const;
+    int getCellCacheCount() const { return cellCache_.size(); }
+
+    // The visible lists are only rebuilt when cells or entities come and go
+    const float &getVisibleRebuildsPerSecond() const { return visibleRebuildsPerSecond_; }
+
+    // Entities and floor tiles skipped or drawn by the last transform()
+    int getCulledCount() const { return culledCount_; }
+    int getDrawnCount() const { return drawnCount_; }
+
 private:
     Player *player_;
     Entity cursor_;
     Ocean ocean_;
     std::vector<Entity *> entities_;
+    SpatialHash entityHash_; // entities_ by local position
+    mutable std::vector<Entity *> nearbyEntities_; // Query results
 
     Camera *camera_;
     ResourceManager *rm_;
     sf::RenderWindow *window_;
 
+    JobPool jobPool_; // Loads WorldCells
     std::unordered_map<int, WorldCell *> cellCache_;
     std::vector<WorldCell *> activeCells_;
+    WorldCell *cellWindow_[3][3]; // Active cells by coordinates mod 3
+    std::vector<WorldCell *> prefetchedCells_;
+    std::list<int> cellUsage_; // Cell ids, most recently used first
+    std::unordered_map<int, std::list<int>::iterator> cellUsageIndex_;
+    std::size_t cellCacheBudget_;
+    std::size_t cellCacheBytes_; // Loaded cells in the cache, as last counted
+    std::vector<WorldCell *> uncountedCells_; // In the cache, not loaded when last counted
     int activeCellId_;
 
     std::vector<Entity *> visibleEntities_;
     std::vector<Entity *> floorEntities_;
+    bool visibleDirty_;
+    int visibleRebuilds_;
+    float visibleRebuildsPerSecond_;
+    float rebuildTimer_;
+    std::vector<std::pair<float, Entity *>> depthKeys_;
+
+    // The parts of the visible lists that are on screen this frame
+    std::vector<Entity *> drawnEntities_;
+    std::vector<Entity *> drawnFloor_;
+    int culledCount_;
+    int drawnCount_;
 
     WorldConfig worldConfig_;
 
     WorldPathfinder pathfinder_;
+    HierarchicalPathfinder hierarchicalPathfinder_;
+    std::vector<std::pair<int, int>> abstractPath_;
+    AsyncPathfinder asyncPathfinder_;
+
+    // Worker searches to add to the path cache once they finish
+    struct UncachedPath
+    {
+        std::shared_ptr<PathRequest> request;
+        uint64_t key;
+        float heuristicWeight;
+        unsigned int version;
+    };
+    std::vector<UncachedPath> uncachedPaths_;
+    DStarLite replanner_;
+    int replannerClearance_; // Agent clearance of the replanner's search
+    std::vector<std::pair<int, int>> failedSteps_; // Cells repairs could not step into
+    std::pair<int, int> failedStepsEnd_; // The goal they were found on the way to
+    std::vector<std::pair<int, int>> changedCells_;
     PathfinderVisualizer pathfinderGrid_;
     bool gridVisible_;
 
     void input_(sf::Time &elapsed);
 
     void updateCells_();
+    // Start loading the cells around where the player will be shortly
+    void prefetchCells_();
+    // Made on first use, loading is requested separately
+    WorldCell *getCell_(const int &i, const int &j);
+    int cellPriority_(const int &i, const int &j);
+    void touchCell_(const int &id);
+    void evictCells_();
+    // Out of the cache and deleted, it must not be active or loading
+    void removeCell_(const int &id);
+    void countLoadedCells_();
     void updateVisibileList_();
+    void depthSort_(std::vector<Entity *> &list);
+    void sortByDepth_(std::vector<Entity *> &list);
+    void cull_(const std::vector<Entity *> &list, const FloatRect &view,
+               std::vector<Entity *> &out_drawn);
+
+    bool pathEnd_(const Vector3f &start, const Vector3f &end, Vector3f &out_end);
+    int agentClearance_(const Entity &entity, const Vector3f &end) const;
+    void cacheFinishedPaths_();
+    void resetReplanner_();
 };
 
 #endif // __WORLD_H__
\ No newline at end of file
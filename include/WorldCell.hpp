@@ -3,7 +3,8 @@
 
 #include <vector>
 #include <random>
-#include <thread>
+#include <memory>
+#include <atomic>
 
 #include "Vector.hpp"
 #include "Entity.hpp"
@@ -15,6 +16,11 @@
 #include "ValueGrid.hpp"
 #include "WorldConfig.hpp"
 #include "RandomGenerator.hpp"
+#include "CellAbstraction.hpp"
+#include "ClearanceMap.hpp"
+#include "ComponentLabels.hpp"
+#include "JobPool.hpp"
+#include "StaticBroadPhase.hpp"
 
 // #ifdef _WIN32
 // #include <Windows.h>
@@ -22,11 +28,31 @@
 // #include <unistd.h>
 // #endif
 
+// Bytes held by a loaded WorldCell
+struct CellMemory
+{
+    std::size_t texture;  // Baked ground texture
+    std::size_t entities; // Trees and the floor entity
+    std::size_t grids;    // Obstacle grid, clearances, components, abstraction
+
+    std::size_t total() const { return texture + entities + grids; }
+};
+
+enum CellLoadState
+{
+    CELL_UNLOADED,
+    CELL_QUEUED,
+    CELL_GENERATING,     // load() running on the job pool
+    CELL_READY_TO_UPLOAD, // Grids and entities built, no texture yet
+    CELL_READY
+};
+
 class WorldCell
 {
 public:
     WorldCell(ResourceManager &rm,
               WorldConfig &worldConfig,
+              JobPool &jobPool,
               const int &i, const int &j);
 
     ~WorldCell();
@@ -37,33 +63,94 @@ public:
     const int &getj() const { return cell_j_; }
 
     void load();
+    // Takes the obstacle grid as given instead of generating the cell, with
+    // no floor or trees. For tests and tools without graphics
+    void loadObstacles(const ValueGrid<int> &obstacles);
+
+    // Published with release ordering once each step's data is complete,
+    // so a reader that sees a state can use everything built before it
+    CellLoadState getLoadState() const { return (CellLoadState)loadState_.load(std::memory_order_acquire); }
+    // Grids and abstraction can be read, from any thread
+    bool isLoaded() const { return getLoadState() >= CELL_READY_TO_UPLOAD; }
+    // Floor and entities can be drawn
+    bool isReady() const { return getLoadState() == CELL_READY; }
+
+    // Make the ground and tree textures once generated, on the main thread
+    // only. True once the cell is ready
+    bool upload();
+
+    // Queue load() on the job pool, or move it in the queue if it is
+    // already there. Lower priorities load first
+    void requestLoad(const int &priority);
+    // Drop a queued load, a load already running still finishes
+    void cancelLoad();
+    bool isLoadQueued() const;
+    bool isLoading() const;
+
+    // All zero until loaded
+    const CellMemory &getMemory() const { return memory_; }
 
     std::vector<Entity *> &getEntities();
     Entity *getFloor();
 
-    void translateOrigin(const Vector3f &newOrigin);
+    // The trees by footprint, keyed by global position. Built by load(),
+    // only queried once the cell is ready and the trees are drawn
+    const StaticBroadPhase &getBroadPhase() const { return broadPhase_; }
 
     const int &obstacleGridValue(const int &i, const int &j) const;
+    const ValueGrid<int> &getObstacleGrid() const { return obstacleGrid_; }
+
+    // Edit the obstacle grid once loaded, on the main thread
+    void setObstacle(const int &i, const int &j, const int &value);
+
+    // Obstacle grid cells changed since the last call, once loaded
+    void takeObstacleChanges(std::vector<std::pair<int, int>> &out);
+
+    // Clearance of each obstacle grid cell for land (layer 0, value 1) and
+    // water (layer 1, value 2). Cells beyond this one count as free,
+    // WorldPathfinder corrects for them when it stitches the window
+    const std::vector<unsigned char> &getClearance(const int &layer) const { return clearance_[layer]; }
+
+    // Connected components of each layer within this cell, labelled from 1
+    // with 0 for blocked cells. WorldPathfinder merges them across borders
+    const std::vector<int> &getComponents(const int &layer) const { return components_[layer]; }
+    const int &getComponentCount(const int &layer) const { return componentCount_[layer]; }
+
+    // Border entrances for hierarchical pathfinding, nullptr until loaded
+    const CellAbstraction *getAbstraction() const;
 
 private:
-    Vector3f origin_;
     ResourceManager *rm_;
     WorldConfig *worldConfig_;
     int cell_i_, cell_j_;
     float width_, height_;
     Vector3f position_;
 
-    Entity *floor_;
+    Ground *floor_;
     std::vector<Entity *> entities_;
     std::vector<Entity *> placeholders_;
+    StaticBroadPhase broadPhase_;
     GroundPlaceHolder placeholder_;
 
     ValueGrid<int> obstacleGrid_;
     void _addObstacle(const Entity &entity);
 
-    std::thread loadThread_;
+    CellAbstraction abstraction_;
+    std::vector<unsigned char> clearance_[2];
+    std::vector<int> components_[2];
+    int componentCount_[2];
+
+    void buildGrids_();
+    void buildClearance_();
+    void buildComponents_();
+
+    CellMemory memory_;
+    void measureMemory_(const Ground &ground);
+
+    JobPool *jobPool_;
+    std::shared_ptr<Job> loadJob_;
 
-    bool loaded_;
+    std::atomic<int> loadState_;
 };
 
 #endif // __WORLDCELL_H__
\ No newline at end of file
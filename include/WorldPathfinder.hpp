@@ -1,23 +1,86 @@
 #ifndef __WORLDPATHFINDER_H__
 #define __WORLDPATHFINDER_H__
 
+#include <cstdint>
+#include <list>
+
 #include "Vector.hpp"
 #include "Pathfinder.hpp"
 #include "WorldConfig.hpp"
 #include "WorldCell.hpp"
+#include "FlowField.hpp"
 
 class WorldPathfinder : public Pathfinder
 {
 public:
     WorldPathfinder(const Vector3f &position, WorldConfig &worldConfig);
 
+    // When the window moves by one cell and the cells it keeps are the
+    // same, only the new row or column of cells is read again
     void setActiveCells(const int &start_i, const int &start_j,
                         const std::vector<WorldCell *> &activeCells);
 
+    // Grid cells changed since the last call, either because an active
+    // cell finished loading or because its obstacle grid was edited
+    void collectChanges(std::vector<std::pair<int, int>> &out_changes);
+
     virtual bool validCell(const int &i, const int &j) const;
     virtual const int &cellValue(const int &i, const int &j) const;
 
-    void setValidCellValue(const int &value) { validCellValue_ = value; }
+    virtual int clearance(const int &i, const int &j) const;
+
+    // WorldCells' components joined across their borders. Only false
+    // when both cells are walkable and can never be connected, agents
+    // wider than a cell may still be unable to get through
+    virtual bool sameComponent(const int &a_i, const int &a_j,
+                               const int &b_i, const int &b_j) const;
+    using Pathfinder::sameComponent;
+
+    // A single clearance lookup when the area fits around its centre cell
+    virtual bool isAreaFree(const Vector3f &localPosition, const Vector3f &size) const;
+
+    virtual bool rowFree(const int &j, const int &start_i, const int &end_i) const;
+    virtual bool rowHasFree(const int &j, const int &start_i, const int &end_i) const;
+
+    // Shared by every entity heading to the goal cell with the current
+    // agent clearance, kept until the active cells or their obstacles change
+    const FlowField &getFlowField(const int &goal_i, const int &goal_j);
+    int getFlowFieldCount() const { return flowFields_.size(); }
+
+    void setValidCellValue(const int &value);
+
+    // Bumped whenever the grid changes, cached paths from older versions
+    // are dropped when they are next looked up
+    const unsigned int &getVersion() const { return version_; }
+
+    // findPath results are cached, with these hits and misses alongside
+    // getRuns(). A hit runs no search
+    const int &getCacheHits() const { return cacheHits_; }
+    const int &getCacheMisses() const { return cacheMisses_; }
+    void setCacheSize(const int &size);
+
+    // The same cache for searches run elsewhere, such as on an
+    // AsyncPathfinder. Keys use the current settings, and paths found on
+    // an older version of the grid are not kept
+    uint64_t getCacheKey(const int &start_i, const int &start_j,
+                         const int &end_i, const int &end_j,
+                         const bool &diagonal,
+                         const PathSearch &search) const;
+    bool findCachedPath(const uint64_t &key,
+                        std::vector<std::pair<int, int>> &resultPath,
+                        bool &out_found);
+    void cachePath(const uint64_t &key, const float &heuristicWeight,
+                   const unsigned int &version,
+                   const bool &found,
+                   const std::vector<std::pair<int, int>> &path);
+    const int &getValidCellValue() const { return validCellValue_; }
+
+protected:
+    virtual bool searchCells_(const int &start_i, const int &start_j,
+                              const int &end_i, const int &end_j,
+                              const bool &diagonal,
+                              const PathSearch &search,
+                              std::vector<std::pair<int, int>> &resultPath);
 
 private:
     int cellCols_;
@@ -26,6 +89,54 @@ private:
     int validCellValue_;
 
     WorldCell *currentCells_[3][3];
+    bool loadedCells_[3][3];
+    int start_i_; // Cell coordinates of the window, once set
+    int start_j_;
+    bool windowSet_;
+
+    std::unordered_map<int, FlowField> flowFields_;
+
+    struct CachedPath
+    {
+        uint64_t key;
+        float heuristicWeight; // Checked with the key, too wide to pack in it
+        unsigned int version;
+        bool found;
+        std::vector<std::pair<int, int>> path;
+    };
+
+    unsigned int version_;
+    int cacheSize_;
+    int cacheHits_;
+    int cacheMisses_;
+    std::list<CachedPath> pathCache_; // Most recently used first
+    std::unordered_map<uint64_t, std::list<CachedPath>::iterator> pathCacheIndex_;
+
+    void gridChanged_();
+
+    // One bit per grid cell for each terrain layer (land = 1, water = 2),
+    // rows padded to whole words. Rebuilt in setActiveCells and patched
+    // from collectChanges as cells finish loading or change
+    int rowWords_;
+    std::vector<uint64_t> walkable_[2];
+
+    int layer_(const int &value) const { return (value == 1 || value == 2) ? value - 1 : -1; }
+    // Per WorldCell clearances stitched over the window, per layer
+    std::vector<unsigned char> clearance_[2];
+
+    // Per layer, the merged component of every WorldCell label. A cell's
+    // labels start after componentOffset_, -1 for blocked cells
+    std::vector<int> componentRoot_[2];
+    int componentOffset_[2][3][3];
+
+    void rebuildWalkable_();
+    void rebuildClearance_();
+    void refreshClearance_(const int &start_i, const int &start_j, const int &end_i, const int &end_j);
+    void shiftGrids_(const int &shift_i, const int &shift_j);
+    void rebuildComponents_();
+    int component_(const int &layer, const int &i, const int &j) const;
+    void updateWalkable_(const int &i, const int &j);
+    bool rowBits_(const int &layer, const int &j, int start_i, int end_i, const bool &all) const;
 
     const int &value_(const int &i, const int &j) const;
 };
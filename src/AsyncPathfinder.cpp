@@ -0,0 +1,224 @@
+#include "AsyncPathfinder.hpp"
+
+const int DEFAULT_NODE_BUDGET = 2000;
+
+PathRequest::PathRequest(const Vector3f &start, const Vector3f &end,
+                         const bool &diagonal, const PathSearch &search) : owner_(nullptr),
+                                                                           start_(start),
+                                                                           end_(end),
+                                                                           diagonal_(diagonal),
+                                                                           search_(search),
+                                                                           heuristicWeight_(1.f),
+                                                                           smoothPath_(false),
+                                                                           partialChanged_(false),
+                                                                           status_(PATH_PENDING)
+{
+}
+
+void PathRequest::cancel()
+{
+    finish_(PATH_CANCELLED);
+}
+
+bool PathRequest::takePartialPath(std::deque<Vector3f> &out_path)
+{
+    std::lock_guard<std::mutex> lock(partialMutex_);
+    if (!partialChanged_)
+        return false;
+
+    out_path = partialPath_;
+    partialChanged_ = false;
+    return true;
+}
+
+bool PathRequest::finish_(const PathRequestStatus &status)
+{
+    // Only the first of the worker and a cancel gets to finish the request
+    int expected = PATH_PENDING;
+    return status_.compare_exchange_strong(expected, status, std::memory_order_acq_rel);
+}
+
+AsyncPathfinder::AsyncPathfinder(const float &width, const float &height,
+                                 const int &gridCols, const int &gridRows) : pathfinder_(Vector3f(0, 0, 0),
+                                                                                         width, height,
+                                                                                         gridCols, gridRows),
+                                                                             stopping_(false),
+                                                                             nodeBudget_(DEFAULT_NODE_BUDGET)
+{
+    workerThread_ = std::thread(&AsyncPathfinder::run_, this);
+}
+
+AsyncPathfinder::~AsyncPathfinder()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto &request : queue_)
+            request->cancel();
+        queue_.clear();
+
+        // Stops the search at its next slice instead of running it out
+        if (active_)
+            active_->cancel();
+    }
+    condition_.notify_all();
+
+    if (workerThread_.joinable())
+        workerThread_.join();
+}
+
+std::shared_ptr<PathRequest> AsyncPathfinder::request(const void *owner,
+                                                      const Pathfinder &source,
+                                                      const Vector3f &start, const Vector3f &end,
+                                                      const bool &diagonal,
+                                                      const PathSearch &search)
+{
+    cancel(owner);
+
+    auto request = std::make_shared<PathRequest>(start, end, diagonal, search);
+    request->owner_ = owner;
+
+    request->heuristicWeight_ = source.getHeuristicWeight();
+    request->smoothPath_ = source.getSmoothPath();
+
+    request->gridPosition_ = source.getPosition();
+    request->grid_.resize(source.getCols() * source.getRows());
+    // Cells too narrow for the source's agent clearance are copied as blocked
+    for (int j = 0; j < source.getRows(); j++)
+    {
+        for (int i = 0; i < source.getCols(); i++)
+        {
+            request->grid_[source.index(i, j)] = source.passableCell(i, j) ? ONE : ZERO;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        latest_[owner] = request;
+        queue_.push_back(request);
+    }
+    condition_.notify_one();
+
+    return request;
+}
+
+void AsyncPathfinder::cancel(const void *owner)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto search = latest_.find(owner);
+    if (search == latest_.end())
+        return;
+
+    search->second->cancel();
+    latest_.erase(search);
+}
+
+int AsyncPathfinder::getOwnerCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_.size();
+}
+
+void AsyncPathfinder::forget_(const std::shared_ptr<PathRequest> &request)
+{
+    // Unless the owner has made a newer request since
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto search = latest_.find(request->owner_);
+    if (search != latest_.end() && search->second == request)
+        latest_.erase(search);
+}
+
+std::shared_ptr<PathRequest> AsyncPathfinder::finished(const void *owner,
+                                                       const Vector3f &start, const Vector3f &end,
+                                                       const bool &diagonal,
+                                                       const PathSearch &search,
+                                                       const bool &found,
+                                                       const std::deque<Vector3f> &path)
+{
+    cancel(owner);
+
+    auto request = std::make_shared<PathRequest>(start, end, diagonal, search);
+    request->path_ = path;
+    request->finish_(found ? PATH_FOUND : PATH_NOT_FOUND);
+    return request;
+}
+
+void AsyncPathfinder::run_()
+{
+    while (true)
+    {
+        std::shared_ptr<PathRequest> request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            active_.reset();
+            condition_.wait(lock, [this]
+                            { return stopping_ || !queue_.empty(); });
+
+            if (stopping_)
+                return;
+
+            request = queue_.front();
+            queue_.pop_front();
+            active_ = request;
+        }
+
+        if (request->isReady())
+        {
+            forget_(request);
+            continue; // Cancelled while queued
+        }
+
+        pathfinder_.setPosition(request->gridPosition_);
+        pathfinder_.setGrid(request->grid_);
+        pathfinder_.setHeuristicWeight(request->heuristicWeight_);
+        pathfinder_.setSmoothPath(request->smoothPath_);
+
+        int start_i, start_j, end_i, end_j;
+        pathfinder_.toGridCoord(request->start_, start_i, start_j);
+        pathfinder_.toGridCoord(request->end_, end_i, end_j);
+        pathfinder_.beginSearch(start_i, start_j, end_i, end_j,
+                                request->diagonal_, request->search_);
+
+        // Searched a slice at a time, so cancelled requests stop early and
+        // the owner can start walking before a long search finishes
+        std::vector<std::pair<int, int>> cells;
+        std::pair<int, int> partialEnd(-1, -1);
+        while (pathfinder_.continueSearch(nodeBudget_) == SEARCH_IN_PROGRESS)
+        {
+            if (request->isReady())
+                break;
+
+            pathfinder_.getSearchPath(cells);
+            if (cells.empty() || cells.back() == partialEnd)
+                continue;
+            partialEnd = cells.back();
+
+            std::deque<Vector3f> partial;
+            pathfinder_.toPath(cells, partial);
+            std::lock_guard<std::mutex> lock(request->partialMutex_);
+            request->partialPath_ = std::move(partial);
+            request->partialChanged_ = true;
+        }
+
+        if (request->isReady())
+        {
+            forget_(request);
+            continue; // Cancelled while searching
+        }
+
+        bool found = pathfinder_.getSearchStatus() == SEARCH_FOUND;
+        std::deque<Vector3f> path;
+        if (found)
+        {
+            pathfinder_.getSearchPath(cells);
+            pathfinder_.toPath(cells, path);
+        }
+
+        // The path is written before the status is published
+        request->path_ = std::move(path);
+        if (found)
+            request->cells_ = std::move(cells);
+        request->finish_(found ? PATH_FOUND : PATH_NOT_FOUND);
+        forget_(request);
+    }
+}
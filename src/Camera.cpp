@@ -170,6 +170,22 @@ Vector3f Camera::projectGround(const Vector2i &point) const
         Vector3f((float)point.x, (float)point.y, 0));
 }
 
+FloatRect Camera::getViewRect() const
+{
+    float r = rotation_ * M_PI / 180.f;
+    float c = std::fabs(std::cos(r));
+    float s = std::fabs(std::sin(r));
+
+    float w = windowWidth_ * zoomFactor_;
+    float h = windowHeight_ * zoomFactor_;
+    float viewWidth = w * c + h * s;
+    float viewHeight = w * s + h * c;
+
+    return FloatRect(windowWidth_ / 2.f - viewWidth / 2.f,
+                     windowHeight_ / 2.f - viewHeight / 2.f,
+                     viewWidth, viewHeight);
+}
+
 void Camera::updateTransforms_()
 {
     translation_ = origin_ - matMultipy(transformMatrix_, position_, 0);
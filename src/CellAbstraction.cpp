@@ -0,0 +1,182 @@
+#include "CellAbstraction.hpp"
+
+CellAbstraction::CellAbstraction() : built_(false),
+                                     validValue_(1)
+{
+}
+
+void CellAbstraction::build(const ValueGrid<int> &grid, const int &validValue)
+{
+    validValue_ = validValue;
+
+    entrances_.clear();
+    for (auto &runs : runs_)
+        runs.clear();
+
+    addRuns_(grid, SIDE_TOP);
+    addRuns_(grid, SIDE_RIGHT);
+    addRuns_(grid, SIDE_BOTTOM);
+    addRuns_(grid, SIDE_LEFT);
+
+    int count = entrances_.size();
+    distances_.assign(count * count, std::numeric_limits<float>::infinity());
+
+    std::vector<float> field;
+    for (int from = 0; from < count; from++)
+    {
+        distanceField(grid, validValue_, entrances_[from].i, entrances_[from].j, field);
+        for (int to = 0; to < count; to++)
+        {
+            distances_[from * count + to] = field[grid.index(entrances_[to].i, entrances_[to].j)];
+        }
+    }
+
+    built_ = true;
+}
+
+void CellAbstraction::addRuns_(const ValueGrid<int> &grid, const int &side)
+{
+    bool horizontal = (side == SIDE_TOP || side == SIDE_BOTTOM);
+    int length = horizontal ? grid.cols() : grid.rows();
+
+    int i, j;
+    int runStart = -1;
+    for (int p = 0; p < length + 1; p++)
+    {
+        bool walkable = false;
+        if (p < length)
+        {
+            i = horizontal ? p : (side == SIDE_RIGHT ? grid.cols() - 1 : 0);
+            j = horizontal ? (side == SIDE_BOTTOM ? grid.rows() - 1 : 0) : p;
+            walkable = (grid.value(i, j) == validValue_);
+        }
+
+        if (walkable && runStart < 0)
+        {
+            runStart = p;
+        }
+        else if (!walkable && runStart >= 0)
+        {
+            int middle = (runStart + p - 1) / 2;
+
+            CellEntrance entrance;
+            entrance.i = horizontal ? middle : (side == SIDE_RIGHT ? grid.cols() - 1 : 0);
+            entrance.j = horizontal ? (side == SIDE_BOTTOM ? grid.rows() - 1 : 0) : middle;
+            entrance.side = side;
+
+            EntranceRun run;
+            run.start = runStart;
+            run.end = p;
+            run.entrance = entrances_.size();
+
+            entrances_.push_back(entrance);
+            runs_[side].push_back(run);
+
+            runStart = -1;
+        }
+    }
+}
+
+int CellAbstraction::findEntrance(const int &side, const int &position) const
+{
+    for (auto &run : runs_[side])
+    {
+        if (position >= run.start && position < run.end)
+            return run.entrance;
+    }
+    return -1;
+}
+
+int CellAbstraction::sidePosition(const int &entrance) const
+{
+    const CellEntrance &e = entrances_[entrance];
+    if (e.side == SIDE_TOP || e.side == SIDE_BOTTOM)
+        return e.i;
+    return e.j;
+}
+
+const EntranceRun &CellAbstraction::getRun(const int &entrance) const
+{
+    const std::vector<EntranceRun> &runs = runs_[entrances_[entrance].side];
+    for (auto &run : runs)
+    {
+        if (run.entrance == entrance)
+            return run;
+    }
+    return runs.front();
+}
+
+CellSide CellAbstraction::oppositeSide(const int &side)
+{
+    switch (side)
+    {
+    case SIDE_TOP:
+        return SIDE_BOTTOM;
+    case SIDE_RIGHT:
+        return SIDE_LEFT;
+    case SIDE_BOTTOM:
+        return SIDE_TOP;
+    default:
+        return SIDE_RIGHT;
+    }
+}
+
+void CellAbstraction::distanceField(const ValueGrid<int> &grid, const int &validValue,
+                                    const int &start_i, const int &start_j,
+                                    std::vector<float> &out)
+{
+    out.assign(grid.cols() * grid.rows(), std::numeric_limits<float>::infinity());
+
+    if (!grid.validIndex(start_i, start_j))
+        return;
+
+    auto walkable = [&grid, &validValue](const int &i, const int &j)
+    {
+        return grid.validIndex(i, j) && grid.value(i, j) == validValue;
+    };
+
+    typedef std::pair<float, int> QueueItem;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+    out[grid.index(start_i, start_j)] = 0;
+    queue.push(QueueItem(0, grid.index(start_i, start_j)));
+
+    while (!queue.empty())
+    {
+        auto [distance, current] = queue.top();
+        queue.pop();
+
+        if (distance > out[current])
+            continue;
+
+        int i = current % grid.cols();
+        int j = current / grid.cols();
+
+        for (int ci = -1; ci < 2; ci++)
+        {
+            for (int cj = -1; cj < 2; cj++)
+            {
+                if (ci == 0 && cj == 0)
+                    continue;
+
+                if (!walkable(i + ci, j + cj))
+                    continue;
+
+                // Same corner cutting rule as Pathfinder
+                if (ci != 0 && cj != 0)
+                {
+                    if (!(walkable(i + ci, j) && walkable(i, j + cj)))
+                        continue;
+                }
+
+                float next = distance + ((ci != 0 && cj != 0) ? M_SQRT2 : 1.f);
+                int nextIndex = grid.index(i + ci, j + cj);
+                if (next < out[nextIndex])
+                {
+                    out[nextIndex] = next;
+                    queue.push(QueueItem(next, nextIndex));
+                }
+            }
+        }
+    }
+}
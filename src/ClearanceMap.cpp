@@ -0,0 +1,120 @@
+#include "ClearanceMap.hpp"
+
+void ClearanceMap::build(const std::vector<char> &walkable,
+                         const int &cols, const int &rows,
+                         const bool &edgeBlocked,
+                         std::vector<unsigned char> &out)
+{
+    out.resize(cols * rows);
+
+    int edge = edgeBlocked ? 0 : MAX_CLEARANCE;
+    auto at = [&](const int &i, const int &j)
+    {
+        if (i < 0 || i > cols - 1 || j < 0 || j > rows - 1)
+            return edge;
+        return (int)out[i + cols * j];
+    };
+
+    // Two chamfer passes with unit steps in all 8 directions give the
+    // exact chessboard distance
+    for (int j = 0; j < rows; j++)
+    {
+        for (int i = 0; i < cols; i++)
+        {
+            if (!walkable[i + cols * j])
+            {
+                out[i + cols * j] = 0;
+                continue;
+            }
+            int d = MAX_CLEARANCE;
+            d = std::min(d, at(i - 1, j) + 1);
+            d = std::min(d, at(i - 1, j - 1) + 1);
+            d = std::min(d, at(i, j - 1) + 1);
+            d = std::min(d, at(i + 1, j - 1) + 1);
+            out[i + cols * j] = d;
+        }
+    }
+
+    for (int j = rows - 1; j >= 0; j--)
+    {
+        for (int i = cols - 1; i >= 0; i--)
+        {
+            int d = out[i + cols * j];
+            if (d == 0)
+                continue;
+            d = std::min(d, at(i + 1, j) + 1);
+            d = std::min(d, at(i + 1, j + 1) + 1);
+            d = std::min(d, at(i, j + 1) + 1);
+            d = std::min(d, at(i - 1, j + 1) + 1);
+            out[i + cols * j] = d;
+        }
+    }
+}
+
+void ClearanceMap::build(const ValueGrid<int> &grid, const int &validValue,
+                         std::vector<unsigned char> &out)
+{
+    std::vector<char> walkable(grid.cols() * grid.rows());
+    for (int j = 0; j < grid.rows(); j++)
+    {
+        for (int i = 0; i < grid.cols(); i++)
+        {
+            walkable[grid.index(i, j)] = (grid.value(i, j) == validValue);
+        }
+    }
+
+    build(walkable, grid.cols(), grid.rows(), false, out);
+}
+
+void ClearanceMap::lowerFrom(const std::vector<int> &seeds,
+                             const int &cols, const int &rows,
+                             std::vector<unsigned char> &clearance)
+{
+    // Breadth first out of the seeds, one ring per unit of distance
+    std::vector<unsigned char> distance(cols * rows, MAX_CLEARANCE);
+    std::vector<int> ring;
+    std::vector<int> nextRing;
+
+    for (auto &seed : seeds)
+    {
+        distance[seed] = 0;
+        ring.push_back(seed);
+    }
+
+    for (int d = 1; d < MAX_CLEARANCE && !ring.empty(); d++)
+    {
+        nextRing.clear();
+        for (auto &cell : ring)
+        {
+            int i = cell % cols;
+            int j = cell / cols;
+            for (int ci = -1; ci < 2; ci++)
+            {
+                for (int cj = -1; cj < 2; cj++)
+                {
+                    if (i + ci < 0 || i + ci > cols - 1 || j + cj < 0 || j + cj > rows - 1)
+                        continue;
+                    int neighbour = (i + ci) + cols * (j + cj);
+                    if (distance[neighbour] > d)
+                    {
+                        distance[neighbour] = d;
+                        nextRing.push_back(neighbour);
+                    }
+                }
+            }
+        }
+        std::swap(ring, nextRing);
+    }
+
+    for (int cell = 0; cell < cols * rows; cell++)
+    {
+        clearance[cell] = std::min(clearance[cell], distance[cell]);
+    }
+}
+
+int ClearanceMap::needed(const float &size, const float &cellSize)
+{
+    // Smallest c with a (2 * c - 1) cell square covering the size
+    int cells = (int)ceil(size / cellSize);
+    return std::min(std::max((cells + 2) / 2, 1), MAX_CLEARANCE);
+}
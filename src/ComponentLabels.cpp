@@ -0,0 +1,58 @@
+#include "ComponentLabels.hpp"
+
+int ComponentLabels::build(const std::vector<char> &walkable,
+                           const int &cols, const int &rows,
+                           std::vector<int> &out)
+{
+    out.assign(cols * rows, 0);
+
+    int count = 0;
+    std::vector<int> stack;
+    for (int first = 0; first < cols * rows; first++)
+    {
+        if (!walkable[first] || out[first] != 0)
+            continue;
+
+        // Flood the new component
+        count += 1;
+        out[first] = count;
+        stack.push_back(first);
+        while (!stack.empty())
+        {
+            int cell = stack.back();
+            stack.pop_back();
+
+            int i = cell % cols;
+            int j = cell / cols;
+            int neighbours[4][2] = {{i - 1, j}, {i + 1, j}, {i, j - 1}, {i, j + 1}};
+            for (auto &n : neighbours)
+            {
+                if (n[0] < 0 || n[0] > cols - 1 || n[1] < 0 || n[1] > rows - 1)
+                    continue;
+                int neighbour = n[0] + cols * n[1];
+                if (walkable[neighbour] && out[neighbour] == 0)
+                {
+                    out[neighbour] = count;
+                    stack.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+int ComponentLabels::build(const ValueGrid<int> &grid, const int &validValue,
+                           std::vector<int> &out)
+{
+    std::vector<char> walkable(grid.cols() * grid.rows());
+    for (int j = 0; j < grid.rows(); j++)
+    {
+        for (int i = 0; i < grid.cols(); i++)
+        {
+            walkable[grid.index(i, j)] = (grid.value(i, j) == validValue);
+        }
+    }
+
+    return build(walkable, grid.cols(), grid.rows(), out);
+}
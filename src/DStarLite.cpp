@@ -0,0 +1,353 @@
+#include "DStarLite.hpp"
+
+const float INFINITE_COST = std::numeric_limits<float>::infinity();
+
+// Keys are sums of float costs, equal keys can differ in the last bits
+const float KEY_EPSILON = 1e-3f;
+
+DStarLite::DStarLite(const Pathfinder &pathfinder) : pathfinder_(&pathfinder),
+                                                     cols_(pathfinder.getCols()),
+                                                     rows_(pathfinder.getRows()),
+                                                     start_(-1),
+                                                     last_(-1),
+                                                     goal_(-1),
+                                                     km_(0),
+                                                     runs_(0)
+{
+    blocked_.assign(cols_ * rows_, 0);
+}
+
+void DStarLite::reset()
+{
+    goal_ = -1;
+    start_ = -1;
+    last_ = -1;
+    queue_.clear();
+    pending_.clear();
+    std::fill(blocked_.begin(), blocked_.end(), 0);
+}
+
+bool DStarLite::plan(const int &start_i, const int &start_j,
+                     const int &goal_i, const int &goal_j,
+                     std::vector<std::pair<int, int>> &resultPath)
+{
+    runs_ = 0;
+    resultPath.clear();
+
+    if (!(pathfinder_->validIndex(start_i, start_j) && pathfinder_->validIndex(goal_i, goal_j)))
+        return false;
+
+    int start = pathfinder_->index(start_i, start_j);
+    int goal = pathfinder_->index(goal_i, goal_j);
+
+    if (goal != goal_)
+    {
+        initialize_(start, goal);
+    }
+    else
+    {
+        // The start moved, keys already queued become lower bounds
+        km_ += heuristic_(last_, start);
+        last_ = start;
+        start_ = start;
+
+        for (auto &cell : pending_)
+        {
+            int i = cell % cols_;
+            int j = cell / cols_;
+            for (int ci = -1; ci < 2; ci++)
+            {
+                for (int cj = -1; cj < 2; cj++)
+                {
+                    if (pathfinder_->validIndex(i + ci, j + cj))
+                        updateRhs_(pathfinder_->index(i + ci, j + cj));
+                }
+            }
+        }
+    }
+    pending_.clear();
+
+    computeShortestPath_();
+
+    if (rhs_[start_] == INFINITE_COST)
+        return false;
+
+    // Follow the cheapest successor down to the goal
+    int current = start_;
+    resultPath.push_back(std::pair<int, int>(current % cols_, current / cols_));
+    while (current != goal_ && resultPath.size() < g_.size())
+    {
+        int i = current % cols_;
+        int j = current / cols_;
+        int next = -1;
+        float best = INFINITE_COST;
+        for (int ci = -1; ci < 2; ci++)
+        {
+            for (int cj = -1; cj < 2; cj++)
+            {
+                if ((ci == 0 && cj == 0) || !pathfinder_->validIndex(i + ci, j + cj))
+                    continue;
+                int neighbour = pathfinder_->index(i + ci, j + cj);
+                float c = cost_(current, neighbour) + g_[neighbour];
+                if (c < best)
+                {
+                    best = c;
+                    next = neighbour;
+                }
+            }
+        }
+        if (next < 0)
+            return false;
+        current = next;
+        resultPath.push_back(std::pair<int, int>(current % cols_, current / cols_));
+    }
+
+    return current == goal_;
+}
+
+void DStarLite::updateCells(const std::vector<std::pair<int, int>> &cells,
+                            const int &clearance)
+{
+    if (!hasGoal())
+        return;
+
+    int radius = std::max(clearance, 1) - 1;
+    if (radius == 0)
+    {
+        for (auto [i, j] : cells)
+        {
+            if (pathfinder_->validIndex(i, j))
+                pending_.push_back(pathfinder_->index(i, j));
+        }
+        return;
+    }
+
+    // Neighbourhoods of nearby changes overlap, queue each cell once
+    std::vector<char> marked(cols_ * rows_, 0);
+    for (auto &cell : pending_)
+    {
+        marked[cell] = 1;
+    }
+
+    for (auto [i, j] : cells)
+    {
+        for (int ci = i - radius; ci <= i + radius; ci++)
+        {
+            for (int cj = j - radius; cj <= j + radius; cj++)
+            {
+                if (!pathfinder_->validIndex(ci, cj))
+                    continue;
+
+                int cell = pathfinder_->index(ci, cj);
+                if (marked[cell])
+                    continue;
+
+                marked[cell] = 1;
+                pending_.push_back(cell);
+            }
+        }
+    }
+}
+
+void DStarLite::setBlocked(const int &i, const int &j, const bool &blocked)
+{
+    if (!pathfinder_->validIndex(i, j))
+        return;
+
+    int cell = pathfinder_->index(i, j);
+    if (blocked_[cell] == blocked)
+        return;
+
+    blocked_[cell] = blocked;
+    if (hasGoal())
+        pending_.push_back(cell);
+}
+
+void DStarLite::clearBlocked()
+{
+    for (int cell = 0; cell < blocked_.size(); cell++)
+    {
+        if (!blocked_[cell])
+            continue;
+
+        blocked_[cell] = 0;
+        if (hasGoal())
+            pending_.push_back(cell);
+    }
+}
+
+void DStarLite::setBlockedCells(const std::vector<std::pair<int, int>> &cells)
+{
+    std::vector<char> blocked(blocked_.size(), 0);
+    for (auto [i, j] : cells)
+    {
+        if (pathfinder_->validIndex(i, j))
+            blocked[pathfinder_->index(i, j)] = 1;
+    }
+
+    for (int cell = 0; cell < blocked_.size(); cell++)
+    {
+        if (blocked_[cell] == blocked[cell])
+            continue;
+
+        blocked_[cell] = blocked[cell];
+        if (hasGoal())
+            pending_.push_back(cell);
+    }
+}
+
+bool DStarLite::validCell(const int &i, const int &j) const
+{
+    if (!pathfinder_->passableCell(i, j))
+        return false;
+
+    return !blocked_[pathfinder_->index(i, j)];
+}
+
+void DStarLite::initialize_(const int &start, const int &goal)
+{
+    start_ = start;
+    last_ = start;
+    goal_ = goal;
+    km_ = 0;
+
+    g_.assign(cols_ * rows_, INFINITE_COST);
+    rhs_.assign(cols_ * rows_, INFINITE_COST);
+    queued_.assign(cols_ * rows_, 0);
+    queuedKey_.resize(cols_ * rows_);
+    queue_.clear();
+
+    rhs_[goal_] = 0;
+    updateVertex_(goal_);
+}
+
+DStarLite::Key DStarLite::calculateKey_(const int &cell) const
+{
+    float m = std::min(g_[cell], rhs_[cell]);
+    return Key(m + heuristic_(start_, cell) + km_, m);
+}
+
+void DStarLite::updateVertex_(const int &cell)
+{
+    if (queued_[cell])
+    {
+        queue_.erase(std::pair<Key, int>(queuedKey_[cell], cell));
+        queued_[cell] = 0;
+    }
+
+    if (g_[cell] != rhs_[cell])
+    {
+        queuedKey_[cell] = calculateKey_(cell);
+        queue_.insert(std::pair<Key, int>(queuedKey_[cell], cell));
+        queued_[cell] = 1;
+    }
+}
+
+void DStarLite::updateRhs_(const int &cell)
+{
+    if (cell != goal_)
+    {
+        int i = cell % cols_;
+        int j = cell / cols_;
+        float best = INFINITE_COST;
+        for (int ci = -1; ci < 2; ci++)
+        {
+            for (int cj = -1; cj < 2; cj++)
+            {
+                if ((ci == 0 && cj == 0) || !pathfinder_->validIndex(i + ci, j + cj))
+                    continue;
+                int neighbour = pathfinder_->index(i + ci, j + cj);
+                best = std::min(best, cost_(cell, neighbour) + g_[neighbour]);
+            }
+        }
+        rhs_[cell] = best;
+    }
+    updateVertex_(cell);
+}
+
+void DStarLite::computeShortestPath_()
+{
+    while (!queue_.empty() &&
+           (keyBefore_(queue_.begin()->first, calculateKey_(start_)) || rhs_[start_] != g_[start_]))
+    {
+        runs_ += 1;
+
+        auto [oldKey, cell] = *queue_.begin();
+        Key newKey = calculateKey_(cell);
+
+        if (oldKey < newKey)
+        {
+            updateVertex_(cell);
+            continue;
+        }
+
+        int i = cell % cols_;
+        int j = cell / cols_;
+
+        if (g_[cell] > rhs_[cell])
+        {
+            g_[cell] = rhs_[cell];
+            updateVertex_(cell);
+            for (int ci = -1; ci < 2; ci++)
+            {
+                for (int cj = -1; cj < 2; cj++)
+                {
+                    if ((ci == 0 && cj == 0) || !pathfinder_->validIndex(i + ci, j + cj))
+                        continue;
+                    int neighbour = pathfinder_->index(i + ci, j + cj);
+                    if (neighbour != goal_)
+                    {
+                        rhs_[neighbour] = std::min(rhs_[neighbour], cost_(neighbour, cell) + g_[cell]);
+                        updateVertex_(neighbour);
+                    }
+                }
+            }
+        }
+        else
+        {
+            g_[cell] = INFINITE_COST;
+            updateRhs_(cell);
+            for (int ci = -1; ci < 2; ci++)
+            {
+                for (int cj = -1; cj < 2; cj++)
+                {
+                    if ((ci == 0 && cj == 0) || !pathfinder_->validIndex(i + ci, j + cj))
+                        continue;
+                    updateRhs_(pathfinder_->index(i + ci, j + cj));
+                }
+            }
+        }
+    }
+}
+
+bool DStarLite::keyBefore_(const Key &a, const Key &b) const
+{
+    if (a.first < b.first - KEY_EPSILON)
+        return true;
+    if (a.first > b.first + KEY_EPSILON)
+        return false;
+    return a.second < b.second + KEY_EPSILON;
+}
+
+float DStarLite::cost_(const int &from, const int &to) const
+{
+    int from_i = from % cols_;
+    int from_j = from / cols_;
+    int to_i = to % cols_;
+    int to_j = to / cols_;
+
+    if (!validCell(from_i, from_j))
+        return INFINITE_COST;
+
+    // Pathfinder's step rule, with the cells blocked here as well
+    return Pathfinder::stepCost(from_i, from_j, to_i - from_i, to_j - from_j,
+                                [this](const int &i, const int &j)
+                                { return validCell(i, j); });
+}
+
+float DStarLite::heuristic_(const int &a, const int &b) const
+{
+    int di = abs(a % cols_ - b % cols_);
+    int dj = abs(a / cols_ - b / cols_);
+    return (float)std::max(di, dj) + (M_SQRT2 - 1.f) * (float)std::min(di, dj);
+}
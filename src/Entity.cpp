@@ -54,6 +54,22 @@ void Entity::draw(sf::RenderTarget *screen)
     screen->draw(baseRect2_);
 }
 
+FloatRect Entity::getScreenBounds(const Camera &camera) const
+{
+    Vector3f t = camera.transform(baseRect3_[0] + getPosition());
+    float left = t.x, right = t.x, top = t.y, bottom = t.y;
+    for (int i = 1; i < 4; ++i)
+    {
+        t = camera.transform(baseRect3_[i] + getPosition());
+        left = std::min(left, t.x);
+        right = std::max(right, t.x);
+        top = std::min(top, t.y);
+        bottom = std::max(bottom, t.y);
+    }
+
+    return FloatRect(left, top, right - left, bottom - top);
+}
+
 Vector3f Entity::getPosition() const
 {
     return origin_ + position_;
@@ -161,8 +177,10 @@ Vector2f Entity::getScreenPosition2() const
 
 bool Entity::collision(const Entity &other)
 {
+    // The other entity may not have been moved to this one's origin
     Vector3f origin = getLocalPosition() - (getSize() / 2.f);
-    Vector3f otherOrigin = other.getLocalPosition() - (other.getSize() / 2.f);
+    Vector3f otherOrigin = translateOrigin(other.getOrigin(), origin_, other.getLocalPosition()) -
+                           (other.getSize() / 2.f);
 
     if ((origin.x < otherOrigin.x + other.getSize().x) &&
         (origin.x + getSize().x > otherOrigin.x) &&
@@ -0,0 +1,162 @@
+#include "FlowField.hpp"
+
+FlowField::FlowField(const Pathfinder &pathfinder) : pathfinder_(&pathfinder),
+                                                     cols_(pathfinder.getCols()),
+                                                     rows_(pathfinder.getRows()),
+                                                     goal_i_(-1),
+                                                     goal_j_(-1),
+                                                     runs_(0)
+{
+    for (int ci = -1; ci < 2; ci++)
+    {
+        for (int cj = -1; cj < 2; cj++)
+        {
+            Vector3f direction((float)ci * pathfinder.getCellWidth(), (float)cj * pathfinder.getCellHeight(), 0.f);
+            if (ci != 0 || cj != 0)
+                direction = direction / std::sqrt(vecMagnitude2(direction));
+            unitDirections_[(ci + 1) + 3 * (cj + 1)] = direction;
+        }
+    }
+}
+
+void FlowField::build(const int &goal_i, const int &goal_j)
+{
+    goal_i_ = goal_i;
+    goal_j_ = goal_j;
+
+    integrate_();
+    buildDirections_();
+}
+
+float FlowField::cost(const int &i, const int &j) const
+{
+    if (!pathfinder_->validIndex(i, j) || costs_.empty())
+        return std::numeric_limits<float>::infinity();
+
+    return costs_[pathfinder_->index(i, j)];
+}
+
+bool FlowField::reachable(const int &i, const int &j) const
+{
+    return cost(i, j) != std::numeric_limits<float>::infinity();
+}
+
+bool FlowField::next(const int &i, const int &j, int &out_i, int &out_j) const
+{
+    if (!pathfinder_->validIndex(i, j) || directions_.empty())
+        return false;
+
+    int direction = directions_[pathfinder_->index(i, j)];
+    if (direction < 0)
+        return false;
+
+    out_i = i + (direction % 3) - 1;
+    out_j = j + (direction / 3) - 1;
+    return true;
+}
+
+Vector3f FlowField::direction(const Vector3f &point) const
+{
+    int i, j;
+    pathfinder_->toGridCoord(point, i, j);
+
+    if (!pathfinder_->validIndex(i, j) || directions_.empty())
+        return Vector3f(0.f, 0.f, 0.f);
+
+    int direction = directions_[pathfinder_->index(i, j)];
+    if (direction < 0)
+        return Vector3f(0.f, 0.f, 0.f);
+
+    return unitDirections_[direction];
+}
+
+void FlowField::integrate_()
+{
+    runs_ = 0;
+    costs_.assign(cols_ * rows_, std::numeric_limits<float>::infinity());
+
+    if (!pathfinder_->passableCell(goal_i_, goal_j_))
+        return;
+
+    typedef std::pair<float, int> QueueItem;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+    int goal = pathfinder_->index(goal_i_, goal_j_);
+    costs_[goal] = 0;
+    queue.push(QueueItem(0, goal));
+
+    while (!queue.empty())
+    {
+        auto [distance, current] = queue.top();
+        queue.pop();
+
+        if (distance > costs_[current])
+            continue;
+
+        runs_ += 1;
+
+        int i = current % cols_;
+        int j = current / cols_;
+
+        for (int ci = -1; ci < 2; ci++)
+        {
+            for (int cj = -1; cj < 2; cj++)
+            {
+                if (ci == 0 && cj == 0)
+                    continue;
+
+                // The step rule is symmetric, so the field can be walked in
+                // the other direction
+                float step = pathfinder_->stepCost(i, j, ci, cj);
+                if (step == std::numeric_limits<float>::infinity())
+                    continue;
+
+                float next = distance + step;
+                int nextIndex = pathfinder_->index(i + ci, j + cj);
+                if (next < costs_[nextIndex])
+                {
+                    costs_[nextIndex] = next;
+                    queue.push(QueueItem(next, nextIndex));
+                }
+            }
+        }
+    }
+}
+
+void FlowField::buildDirections_()
+{
+    directions_.assign(cols_ * rows_, -1);
+
+    for (int j = 0; j < rows_; j++)
+    {
+        for (int i = 0; i < cols_; i++)
+        {
+            int current = pathfinder_->index(i, j);
+            if (costs_[current] == std::numeric_limits<float>::infinity() || costs_[current] == 0)
+                continue;
+
+            // The neighbour that Dijkstra came from has cost + step equal
+            // to this cell's cost, take the one that matches best
+            float best = std::numeric_limits<float>::infinity();
+            for (int ci = -1; ci < 2; ci++)
+            {
+                for (int cj = -1; cj < 2; cj++)
+                {
+                    if (ci == 0 && cj == 0)
+                        continue;
+
+                    float step = pathfinder_->stepCost(i, j, ci, cj);
+                    if (step == std::numeric_limits<float>::infinity())
+                        continue;
+
+                    float c = costs_[pathfinder_->index(i + ci, j + cj)] + step;
+                    if (c < best)
+                    {
+                        best = c;
+                        directions_[current] = (ci + 1) + 3 * (cj + 1);
+                    }
+                }
+            }
+        }
+    }
+}
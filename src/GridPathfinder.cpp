@@ -17,17 +17,20 @@ GridPathfinder::GridPathfinder(const Vector3f &position,
 void GridPathfinder::clearGrid()
 {
     std::fill(grid_.begin(), grid_.end(), ONE);
+    clearance_.clear();
 }
 
 void GridPathfinder::setGrid(const std::vector<int> &grid)
 {
     grid_ = grid;
+    clearance_.clear();
 }
 
 void GridPathfinder::setActiveGridArea(const int &cols, const int &rows)
 {
     active_cols_ = cols;
     active_rows_ = rows;
+    clearance_.clear();
 }
 
 void GridPathfinder::addObstacle(const Entity &entity)
@@ -63,6 +66,32 @@ void GridPathfinder::setCellValue(const int &i, const int &j, const int &value)
         return;
 
     grid_[index(i, j)] = value;
+    clearance_.clear();
+}
+
+void GridPathfinder::buildClearance()
+{
+    std::vector<char> walkable(getCols() * getRows());
+    for (int j = 0; j < getRows(); j++)
+    {
+        for (int i = 0; i < getCols(); i++)
+        {
+            walkable[index(i, j)] = validCell(i, j);
+        }
+    }
+
+    ClearanceMap::build(walkable, getCols(), getRows(), true, clearance_);
+}
+
+int GridPathfinder::clearance(const int &i, const int &j) const
+{
+    if (clearance_.empty())
+        return Pathfinder::clearance(i, j);
+
+    if (!validIndex(i, j))
+        return 0;
+
+    return clearance_[index(i, j)];
 }
 
 bool GridPathfinder::validIndex(const int &i, const int &j) const
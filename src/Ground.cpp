@@ -27,7 +27,8 @@ Ground::Ground(ResourceManager &rm,
         int(j_hat.x),
         int(j_hat.y));
 
-    sf::Image floor;
+    // Baked off the main thread, uploadTexture() makes the texture later
+    sf::Image &floor = floorImage_;
     floor.create(cols_ * 64, rows_ * 32 + 32, sf::Color::Transparent);
 
     sf::Image grass;
@@ -188,8 +189,6 @@ Ground::Ground(ResourceManager &rm,
     // }
     // Coastline gen method 2
 
-    floor_.loadFromImage(floor);
-
     float w = cols_ * 64;
     float h = rows_ * 32;
     floorShape_[0].position = Vector2f(0, 0);
@@ -219,11 +218,32 @@ void Ground::transform(Camera &camera)
                                            0, 0, 1);
 }
 
+FloatRect Ground::getScreenBounds(const Camera &camera) const
+{
+    // The floor diamond hangs below its top corner at the cell origin
+    Vector3f screenPosition = camera.transform(getPosition());
+    float w = cols_ * 64;
+    float h = rows_ * 32;
+    return FloatRect(screenPosition.x - w / 2.f, screenPosition.y, w, h);
+}
+
 void Ground::draw(sf::RenderTarget *screen)
 {
     screen->draw(floorShape_, floorRender_);
 }
 
+void Ground::uploadTexture()
+{
+    floor_.loadFromImage(floorImage_);
+    floorImage_ = sf::Image();
+}
+
+std::size_t Ground::getTextureBytes() const
+{
+    // Same size as floorImage_, before and after the upload
+    return (std::size_t)(cols_ * 64) * (rows_ * 32 + 32) * 4;
+}
+
 GroundPlaceHolder::GroundPlaceHolder(ResourceManager &rm,
                                      const int &rows, const int &cols) : Entity(rm),
                                                                          rows_(rows),
@@ -252,6 +272,14 @@ void GroundPlaceHolder::transform(Camera &camera)
                                            0, 0, 1);
 }
 
+FloatRect GroundPlaceHolder::getScreenBounds(const Camera &camera) const
+{
+    Vector3f screenPosition = camera.transform(getPosition());
+    float w = cols_ * 64;
+    float h = rows_ * 32;
+    return FloatRect(screenPosition.x - w / 2.f, screenPosition.y, w, h);
+}
+
 void GroundPlaceHolder::draw(sf::RenderTarget *screen)
 {
     screen->draw(floorShape_, floorRender_);
@@ -0,0 +1,253 @@
+#include "HierarchicalPathfinder.hpp"
+
+const int64_t START_KEY = -1;
+const int64_t END_KEY = -2;
+
+HierarchicalPathfinder::HierarchicalPathfinder(WorldConfig &worldConfig,
+                                               std::unordered_map<int, WorldCell *> &cells) : worldConfig_(&worldConfig),
+                                                                                              cells_(&cells),
+                                                                                              runs_(0)
+{
+}
+
+bool HierarchicalPathfinder::findPath(const Vector3f &start, const Vector3f &end,
+                                      std::vector<std::pair<int, int>> &resultPath)
+{
+    int start_i, start_j, end_i, end_j;
+    toGridCoord(start, start_i, start_j);
+    toGridCoord(end, end_i, end_j);
+
+    return searchAbstract(start_i, start_j, end_i, end_j, resultPath);
+}
+
+bool HierarchicalPathfinder::searchAbstract(const int &start_i, const int &start_j,
+                                            const int &end_i, const int &end_j,
+                                            std::vector<std::pair<int, int>> &resultPath)
+{
+    runs_ = 0;
+
+    int subCols = worldConfig_->subCols();
+    int subRows = worldConfig_->subRows();
+
+    int startCell_i = start_i / subCols;
+    int startCell_j = start_j / subRows;
+    int endCell_i = end_i / subCols;
+    int endCell_j = end_j / subRows;
+
+    WorldCell *startCell;
+    WorldCell *endCell;
+    const CellAbstraction *startAbstraction = abstraction_(startCell_i, startCell_j, &startCell);
+    const CellAbstraction *endAbstraction = abstraction_(endCell_i, endCell_j, &endCell);
+
+    if (startAbstraction == nullptr || endAbstraction == nullptr)
+        return false;
+
+    // Connect start and end to the entrances of their own cells
+    CellAbstraction::distanceField(startCell->getObstacleGrid(), startAbstraction->getValidValue(),
+                                   start_i - startCell_i * subCols, start_j - startCell_j * subRows,
+                                   startField_);
+    CellAbstraction::distanceField(endCell->getObstacleGrid(), endAbstraction->getValidValue(),
+                                   end_i - endCell_i * subCols, end_j - endCell_j * subRows,
+                                   endField_);
+
+    nodes_.clear();
+    openQueue_ = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>();
+
+    nodes_[START_KEY] = AbstractNode{start_i, start_j, 0, START_KEY, false};
+    openQueue_.push(QueueItem(0, START_KEY));
+
+    if (startCell == endCell)
+    {
+        float direct = startField_[startCell->getObstacleGrid().index(end_i - endCell_i * subCols,
+                                                                      end_j - endCell_j * subRows)];
+        if (direct != std::numeric_limits<float>::infinity())
+            visit_(END_KEY, START_KEY, end_i, end_j, direct, end_i, end_j);
+    }
+
+    while (!openQueue_.empty())
+    {
+        int64_t currentKey = openQueue_.top().second;
+        openQueue_.pop();
+
+        AbstractNode &current = nodes_[currentKey];
+        if (current.closed)
+            continue;
+        current.closed = true;
+
+        runs_ += 1;
+
+        if (currentKey == END_KEY)
+        {
+            resultPath.clear();
+            int64_t key = END_KEY;
+            while (key != START_KEY)
+            {
+                resultPath.push_back(std::pair<int, int>(nodes_[key].i, nodes_[key].j));
+                key = nodes_[key].parent;
+            }
+            resultPath.push_back(std::pair<int, int>(start_i, start_j));
+            std::reverse(resultPath.begin(), resultPath.end());
+            return true;
+        }
+
+        // Copy, visit_ may rehash nodes_
+        int current_i = current.i;
+        int current_j = current.j;
+        float current_g = current.g;
+
+        int cell_i = current_i / subCols;
+        int cell_j = current_j / subRows;
+        WorldCell *cell;
+        const CellAbstraction *abstraction = abstraction_(cell_i, cell_j, &cell);
+        const std::vector<CellEntrance> &entrances = abstraction->getEntrances();
+
+        if (currentKey == START_KEY)
+        {
+            for (int e = 0; e < entrances.size(); e++)
+            {
+                float d = startField_[cell->getObstacleGrid().index(entrances[e].i, entrances[e].j)];
+                if (d == std::numeric_limits<float>::infinity())
+                    continue;
+                visit_(key_(cell_i, cell_j, e), currentKey,
+                       cell_i * subCols + entrances[e].i, cell_j * subRows + entrances[e].j,
+                       d, end_i, end_j);
+            }
+            continue;
+        }
+
+        int entrance = currentKey - key_(cell_i, cell_j, 0);
+
+        // Other entrances of the same cell
+        for (int e = 0; e < entrances.size(); e++)
+        {
+            float d = abstraction->getDistance(entrance, e);
+            if (e == entrance || d == std::numeric_limits<float>::infinity())
+                continue;
+            visit_(key_(cell_i, cell_j, e), currentKey,
+                   cell_i * subCols + entrances[e].i, cell_j * subRows + entrances[e].j,
+                   current_g + d, end_i, end_j);
+        }
+
+        // The end, when it shares the cell
+        if (cell == endCell)
+        {
+            float d = endField_[cell->getObstacleGrid().index(entrances[entrance].i, entrances[entrance].j)];
+            if (d != std::numeric_limits<float>::infinity())
+                visit_(END_KEY, currentKey, end_i, end_j, current_g + d, end_i, end_j);
+        }
+
+        // Step across the border into the neighbouring cell
+        int side = entrances[entrance].side;
+        int neighbour_i = cell_i + (side == SIDE_RIGHT) - (side == SIDE_LEFT);
+        int neighbour_j = cell_j + (side == SIDE_BOTTOM) - (side == SIDE_TOP);
+        const CellAbstraction *neighbour = abstraction_(neighbour_i, neighbour_j);
+        if (neighbour == nullptr)
+            continue;
+
+        // Every run facing this one is joined wherever the two overlap, not
+        // only where one covers the other's middle
+        int position = abstraction->sidePosition(entrance);
+        const EntranceRun &run = abstraction->getRun(entrance);
+        for (auto &facing : neighbour->getRuns(CellAbstraction::oppositeSide(side)))
+        {
+            int overlapStart = std::max(run.start, facing.start);
+            int overlapEnd = std::min(run.end, facing.end);
+            if (overlapStart >= overlapEnd)
+                continue;
+
+            // Walk along this run to a crossing point, then along the other
+            int otherPosition = neighbour->sidePosition(facing.entrance);
+            int crossA = std::clamp(position, overlapStart, overlapEnd - 1);
+            int crossB = std::clamp(otherPosition, overlapStart, overlapEnd - 1);
+            int cost = std::min(abs(position - crossA) + abs(otherPosition - crossA),
+                                abs(position - crossB) + abs(otherPosition - crossB));
+
+            const CellEntrance &other = neighbour->getEntrances()[facing.entrance];
+            visit_(key_(neighbour_i, neighbour_j, facing.entrance), currentKey,
+                   neighbour_i * subCols + other.i, neighbour_j * subRows + other.j,
+                   current_g + 1.f + (float)cost,
+                   end_i, end_j);
+        }
+    }
+
+    return false;
+}
+
+void HierarchicalPathfinder::visit_(const int64_t &key, const int64_t &parent,
+                                    const int &i, const int &j, const float &g,
+                                    const int &end_i, const int &end_j)
+{
+    auto search = nodes_.find(key);
+    if (search != nodes_.end())
+    {
+        if (search->second.closed || search->second.g <= g)
+            return;
+        search->second.g = g;
+        search->second.parent = parent;
+    }
+    else
+    {
+        nodes_[key] = AbstractNode{i, j, g, parent, false};
+    }
+
+    // Octile distance
+    int di = abs(end_i - i);
+    int dj = abs(end_j - j);
+    float h = (float)std::max(di, dj) + (M_SQRT2 - 1.f) * (float)std::min(di, dj);
+
+    openQueue_.push(QueueItem(g + h, key));
+}
+
+const CellAbstraction *HierarchicalPathfinder::abstraction_(const int &cell_i, const int &cell_j, WorldCell **outCell) const
+{
+    if (!worldConfig_->validCell(cell_i, cell_j))
+        return nullptr;
+
+    auto search = cells_->find(worldConfig_->getId(cell_i, cell_j));
+    if (search == cells_->end())
+        return nullptr;
+
+    const CellAbstraction *abstraction = search->second->getAbstraction();
+    if (abstraction == nullptr || !abstraction->isBuilt())
+        return nullptr;
+
+    if (outCell != nullptr)
+        *outCell = search->second;
+
+    return abstraction;
+}
+
+int64_t HierarchicalPathfinder::key_(const int &cell_i, const int &cell_j, const int &entrance) const
+{
+    // A side has at most subCols / 2 runs, so 256 entrances per cell is plenty
+    return (int64_t)worldConfig_->getId(cell_i, cell_j) * 256 + entrance;
+}
+
+void HierarchicalPathfinder::toGridCoord(const Vector3f &point, int &out_i, int &out_j) const
+{
+    int cell_i = (int)std::floor(point.x / worldConfig_->getCellWidth());
+    int cell_j = (int)std::floor(point.y / worldConfig_->getCellHeight());
+
+    Vector3f cellPosition = worldConfig_->getCellPosition(cell_i, cell_j);
+
+    int local_i = (int)std::floor((point.x - cellPosition.x) / worldConfig_->getCellWidth() * (float)worldConfig_->subCols());
+    int local_j = (int)std::floor((point.y - cellPosition.y) / worldConfig_->getCellHeight() * (float)worldConfig_->subRows());
+
+    out_i = cell_i * worldConfig_->subCols() + std::clamp(local_i, 0, worldConfig_->subCols() - 1);
+    out_j = cell_j * worldConfig_->subRows() + std::clamp(local_j, 0, worldConfig_->subRows() - 1);
+}
+
+Vector3f HierarchicalPathfinder::toPoint(const int &i, const int &j) const
+{
+    int cell_i = i / worldConfig_->subCols();
+    int cell_j = j / worldConfig_->subRows();
+
+    float subCellWidth = worldConfig_->getCellWidth() / (float)worldConfig_->subCols();
+    float subCellHeight = worldConfig_->getCellHeight() / (float)worldConfig_->subRows();
+
+    return worldConfig_->getCellPosition(cell_i, cell_j) +
+           Vector3f(
+               (float)(i - cell_i * worldConfig_->subCols()) * subCellWidth + subCellWidth / 2.f,
+               (float)(j - cell_j * worldConfig_->subRows()) * subCellHeight + subCellHeight / 2.f,
+               0);
+}
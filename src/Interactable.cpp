@@ -30,6 +30,20 @@ void FirePit::draw(sf::RenderTarget *screen)
     screen->draw(fire_);
 }
 
+FloatRect FirePit::getScreenBounds(const Camera &camera) const
+{
+    // The fire is drawn above the base rect
+    FloatRect bounds = Entity::getScreenBounds(camera);
+    Vector3f t = camera.transform(getPosition());
+    float size = fire_.getRadius() * 2.f;
+    float left = std::min(bounds.left, t.x - 20.f);
+    float top = std::min(bounds.top, t.y - 40.f);
+    float right = std::max(bounds.left + bounds.width, t.x - 20.f + size);
+    float bottom = std::max(bounds.top + bounds.height, t.y - 40.f + size);
+
+    return FloatRect(left, top, right - left, bottom - top);
+}
+
 void FirePit::attack() // World &world, Player &player)
 {
     statemachine_.queueEvent(FIREPIT_ATTACK);
@@ -0,0 +1,130 @@
+#include "JobPool.hpp"
+
+JobPool::JobPool(const int &threads) : nextOrder_(0),
+                                       stopping_(false)
+{
+    int count = threads;
+    if (count < 1)
+        count = std::max((int)std::thread::hardware_concurrency(), 1);
+
+    for (int n = 0; n < count; n++)
+        workers_.push_back(std::thread(&JobPool::run_, this));
+}
+
+JobPool::~JobPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto &job : queue_)
+            job->status_ = JOB_CANCELLED;
+        queue_.clear();
+    }
+    jobQueued_.notify_all();
+    jobFinished_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+}
+
+std::shared_ptr<Job> JobPool::submit(const std::function<void()> &work, const int &priority)
+{
+    auto job = std::make_shared<Job>();
+    job->work_ = work;
+    job->priority_ = priority;
+    job->status_ = JOB_QUEUED;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->order_ = nextOrder_++;
+        if (stopping_)
+            job->status_ = JOB_CANCELLED;
+        else
+            queue_.push_back(job);
+    }
+    jobQueued_.notify_one();
+
+    return job;
+}
+
+void JobPool::setPriority(const std::shared_ptr<Job> &job, const int &priority)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    job->priority_ = priority;
+}
+
+bool JobPool::cancel(const std::shared_ptr<Job> &job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (job->getStatus() != JOB_QUEUED)
+            return job->getStatus() == JOB_CANCELLED;
+
+        for (std::size_t n = 0; n < queue_.size(); n++)
+        {
+            if (queue_[n] == job)
+            {
+                queue_.erase(queue_.begin() + n);
+                break;
+            }
+        }
+        job->status_ = JOB_CANCELLED;
+    }
+    jobFinished_.notify_all();
+
+    return true;
+}
+
+void JobPool::wait(const std::shared_ptr<Job> &job)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    jobFinished_.wait(lock, [&job]
+                      { return job->isFinished(); });
+}
+
+int JobPool::getQueuedCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void JobPool::run_()
+{
+    while (true)
+    {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobQueued_.wait(lock, [this]
+                            { return stopping_ || !queue_.empty(); });
+
+            if (stopping_)
+                return;
+
+            // Few jobs are ever queued, a scan keeps priorities changeable
+            std::size_t best = 0;
+            for (std::size_t n = 1; n < queue_.size(); n++)
+            {
+                const Job &a = *queue_[n];
+                const Job &b = *queue_[best];
+                if (a.priority_ < b.priority_ || (a.priority_ == b.priority_ && a.order_ < b.order_))
+                    best = n;
+            }
+
+            job = queue_[best];
+            queue_.erase(queue_.begin() + best);
+            job->status_ = JOB_RUNNING;
+        }
+
+        job->work_();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job->status_ = JOB_DONE;
+        }
+        jobFinished_.notify_all();
+    }
+}
@@ -6,7 +6,11 @@ Pathfinder::Pathfinder(const Vector3f &position,
                                                                    width_(width),
                                                                    height_(height),
                                                                    g_cols_(gridCols),
-                                                                   g_rows_(gridRows)
+                                                                   g_rows_(gridRows),
+                                                                   heuristicWeight_(1.f),
+                                                                   smoothPath_(false),
+                                                                   agentClearance_(1),
+                                                                   searchStatus_(SEARCH_NOT_FOUND)
 {
     cellWidth_ = width_ / ((float)g_cols_);
     cellHeight_ = height_ / ((float)g_rows_);
@@ -26,14 +30,11 @@ bool Pathfinder::isAreaFree(const Vector3f &localPosition, const Vector3f &size)
     int end_i = (int)ceil((topLeft.x + size.x) / cellWidth_);
     int end_j = (int)ceil((topLeft.y + size.y) / cellHeight_);
 
-    for (int i = start_i; i < end_i; i++)
+    for (int j = start_j; j < end_j; j++)
     {
-        for (int j = start_j; j < end_j; j++)
+        if (!rowFree(j, start_i, end_i))
         {
-            if (!validCell(i, j))
-            {
-                return false;
-            }
+            return false;
         }
     }
 
@@ -53,10 +54,30 @@ bool Pathfinder::findFreeCell(const Vector3f &position, const int &maxDiameter,
         return true;
     }
 
+    // The spiral stays within maxDiameter of the start, skip the rows in
+    // that box without a single free cell
+    int left_i = i - maxDiameter;
+    int right_i = i + maxDiameter + 1;
+    int first_j = j - maxDiameter;
+    std::vector<char> rowsWithFree(maxDiameter * 2 + 1, 0);
+    bool anyFree = false;
+    for (int r = 0; r < rowsWithFree.size(); r++)
+    {
+        rowsWithFree[r] = rowHasFree(first_j + r, left_i, right_i);
+        anyFree = anyFree || rowsWithFree[r];
+    }
+
+    if (!anyFree)
+        return false;
+
     SpiralOut spiralOut(i, j, maxDiameter * maxDiameter);
 
     while (spiralOut.next(i, j))
     {
+        int r = j - first_j;
+        if (r >= 0 && r < rowsWithFree.size() && !rowsWithFree[r])
+            continue;
+
         if (validCell(i, j))
         {
             out_i = i;
@@ -81,7 +102,8 @@ bool Pathfinder::findFreePosition(const Vector3f &position, const int &maxDiamet
 
 bool Pathfinder::findPath(const Vector3f &start, const Vector3f &end,
                           const bool &diagonal,
-                          std::deque<Vector3f> &resultPath)
+                          std::deque<Vector3f> &resultPath,
+                          const PathSearch &search)
 {
     int start_i, start_j, end_i, end_j;
     toGridCoord(start, start_i, start_j);
@@ -91,21 +113,159 @@ bool Pathfinder::findPath(const Vector3f &start, const Vector3f &end,
     std::cout << end << end_i << ":" << end_j << " ";
 
     resultPathCells_.clear();
-    bool found = searchAStar(start_i, start_j, end_i, end_j, diagonal, resultPathCells_);
 
-    std::cout << runs_ << "runs ";
+    // Goals on another island or in a closed off lagoon fail at once
+    // instead of after searching everything reachable
+    if (!sameComponent(start_i, start_j, end_i, end_j))
+    {
+        clearSearchStats_();
+        return false;
+    }
+
+    bool found = searchCells_(start_i, start_j, end_i, end_j, diagonal, search, resultPathCells_);
+
+    std::cout << scratch_.runs << "runs ";
 
     if (!found)
         return false;
 
-    for (auto [i, j] : resultPathCells_)
+    toPath(resultPathCells_, resultPath);
+
+    return true;
+}
+
+void Pathfinder::clearSearchStats_()
+{
+    scratch_.runs = 0;
+    scratch_.nodesUsed = 0;
+    scratch_.reusedNodes = 0;
+}
+
+bool Pathfinder::sameComponent(const Vector3f &a, const Vector3f &b) const
+{
+    int a_i, a_j, b_i, b_j;
+    toGridCoord(a, a_i, a_j);
+    toGridCoord(b, b_i, b_j);
+    return sameComponent(a_i, a_j, b_i, b_j);
+}
+
+void Pathfinder::toPath(const std::vector<std::pair<int, int>> &cells,
+                        std::deque<Vector3f> &resultPath) const
+{
+    if (cells.empty())
+        return;
+
+    if (smoothPath_)
+    {
+        std::vector<std::pair<int, int>> smoothedCells;
+        smoothPath(cells, smoothedCells);
+        for (auto [i, j] : smoothedCells)
+        {
+            resultPath.push_back(toPoint(i, j));
+        }
+    }
+    else
     {
-        resultPath.push_back(toPoint(i, j));
+        for (auto [i, j] : cells)
+        {
+            resultPath.push_back(toPoint(i, j));
+        }
     }
 
     resultPath.pop_front();
+}
 
-    return true;
+bool Pathfinder::searchCells_(const int &start_i, const int &start_j,
+                              const int &end_i, const int &end_j,
+                              const bool &diagonal,
+                              const PathSearch &search,
+                              std::vector<std::pair<int, int>> &resultPath)
+{
+    if (search == SEARCH_JPS && diagonal)
+        return searchJPS(start_i, start_j, end_i, end_j, resultPath);
+
+    return searchAStar(start_i, start_j, end_i, end_j, diagonal, resultPath);
+}
+
+void Pathfinder::findPaths(const std::vector<PathQuery> &queries,
+                           const bool &diagonal,
+                           std::vector<PathQueryResult> &results,
+                           const PathSearch &search,
+                           const int &threads)
+{
+    results.resize(queries.size());
+    if (queries.empty())
+        return;
+
+    int workers = threads;
+    if (workers < 1)
+        workers = std::max((int)std::thread::hardware_concurrency(), 1);
+    workers = std::min(workers, (int)queries.size());
+
+    if (batchScratch_.size() < workers)
+        batchScratch_.resize(workers);
+
+    // Workers take the next query until none are left, so a few long
+    // searches do not hold up a whole share of the batch
+    std::atomic<std::size_t> nextQuery(0);
+    auto work = [&](SearchScratch &scratch)
+    {
+        std::vector<std::pair<int, int>> cells;
+        std::size_t q;
+        while ((q = nextQuery.fetch_add(1)) < queries.size())
+        {
+            const PathQuery &query = queries[q];
+            PathQueryResult &result = results[q];
+
+            cells.clear();
+            result.path.clear();
+
+            // Same as findPath, unreachable goals fail without flooding
+            // everything reachable on a worker
+            if (!sameComponent(query.start_i, query.start_j, query.end_i, query.end_j))
+            {
+                result.found = false;
+                result.runs = 0;
+                continue;
+            }
+
+            if (search == SEARCH_JPS && diagonal)
+                result.found = searchJPS_(query.start_i, query.start_j,
+                                          query.end_i, query.end_j,
+                                          cells, scratch);
+            else
+                result.found = searchAStar_(query.start_i, query.start_j,
+                                            query.end_i, query.end_j,
+                                            diagonal, cells, scratch);
+            result.runs = scratch.runs;
+
+            if (!result.found)
+                continue;
+
+            if (smoothPath_)
+                smoothPath(cells, result.path);
+            else
+                result.path.swap(cells);
+        }
+    };
+
+    // The calling thread is one of the workers
+    if (workers > 1 && (batchPool_ == nullptr || batchPool_->getThreadCount() < workers - 1))
+        batchPool_ = std::make_unique<JobPool>(workers - 1);
+
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (int w = 1; w < workers; w++)
+    {
+        jobs.push_back(batchPool_->submit([&, w]
+                                          { work(batchScratch_[w]); },
+                                          0));
+    }
+    work(batchScratch_[0]);
+
+    for (auto &job : jobs)
+    {
+        batchPool_->wait(job);
+    }
 }
 
 bool Pathfinder::searchAStar(const int &start_i, const int &start_j,
@@ -113,7 +273,93 @@ bool Pathfinder::searchAStar(const int &start_i, const int &start_j,
                              const bool &diagonal,
                              std::vector<std::pair<int, int>> &resultPath)
 {
-    runs_ = 0;
+    return searchAStar_(start_i, start_j, end_i, end_j, diagonal, resultPath, scratch_);
+}
+
+bool Pathfinder::searchAStar_(const int &start_i, const int &start_j,
+                              const int &end_i, const int &end_j,
+                              const bool &diagonal,
+                              std::vector<std::pair<int, int>> &resultPath,
+                              SearchScratch &scratch) const
+{
+    if (!startSearch_(start_i, start_j, end_i, end_j, diagonal, SEARCH_ASTAR, scratch))
+        return false;
+
+    if (stepSearch_(std::numeric_limits<int>::max(), scratch) != SEARCH_FOUND)
+        return false;
+
+    buildPath_(scratch.goalNode, resultPath);
+    return true;
+}
+
+bool Pathfinder::searchJPS(const int &start_i, const int &start_j,
+                           const int &end_i, const int &end_j,
+                           std::vector<std::pair<int, int>> &resultPath)
+{
+    return searchJPS_(start_i, start_j, end_i, end_j, resultPath, scratch_);
+}
+
+bool Pathfinder::searchJPS_(const int &start_i, const int &start_j,
+                            const int &end_i, const int &end_j,
+                            std::vector<std::pair<int, int>> &resultPath,
+                            SearchScratch &scratch) const
+{
+    if (!startSearch_(start_i, start_j, end_i, end_j, true, SEARCH_JPS, scratch))
+        return false;
+
+    if (stepSearch_(std::numeric_limits<int>::max(), scratch) != SEARCH_FOUND)
+        return false;
+
+    buildPath_(scratch.goalNode, resultPath);
+    return true;
+}
+
+bool Pathfinder::beginSearch(const int &start_i, const int &start_j,
+                             const int &end_i, const int &end_j,
+                             const bool &diagonal,
+                             const PathSearch &search)
+{
+    searchStatus_ = SEARCH_NOT_FOUND;
+    if (startSearch_(start_i, start_j, end_i, end_j, diagonal, search, resumable_))
+        searchStatus_ = SEARCH_IN_PROGRESS;
+
+    return searchStatus_ == SEARCH_IN_PROGRESS;
+}
+
+const SearchStatus &Pathfinder::continueSearch(const int &nodeBudget)
+{
+    if (searchStatus_ == SEARCH_IN_PROGRESS)
+        searchStatus_ = stepSearch_(std::max(nodeBudget, 1), resumable_);
+
+    return searchStatus_;
+}
+
+void Pathfinder::getSearchPath(std::vector<std::pair<int, int>> &resultPath) const
+{
+    resultPath.clear();
+
+    if (searchStatus_ == SEARCH_FOUND)
+    {
+        buildPath_(resumable_.goalNode, resultPath);
+        return;
+    }
+
+    // Towards the closed node nearest the goal, nothing if that is the start
+    if (resumable_.bestNode == nullptr || resumable_.bestNode->parent == nullptr)
+        return;
+
+    buildPath_(resumable_.bestNode, resultPath);
+}
+
+bool Pathfinder::startSearch_(const int &start_i, const int &start_j,
+                              const int &end_i, const int &end_j,
+                              const bool &diagonal,
+                              const PathSearch &search,
+                              SearchScratch &scratch) const
+{
+    scratch.runs = 0;
+    scratch.bestNode = nullptr;
+    scratch.goalNode = nullptr;
 
     if (!(validIndex(start_i, start_j) && validIndex(end_i, end_j)))
         return false;
@@ -121,105 +367,446 @@ bool Pathfinder::searchAStar(const int &start_i, const int &start_j,
     if ((start_i == end_i) && (start_j == end_j))
         return false;
 
+    scratch.end_i = end_i;
+    scratch.end_j = end_j;
+    scratch.diagonal = diagonal || search == SEARCH_JPS;
+    scratch.jps = (search == SEARCH_JPS) && scratch.diagonal;
+
     // Clear the data structures
-    openQueue_ = std::priority_queue<Node *, std::vector<Node *>, MoreThanByF>();
-    openList_.clear();
-    closedList_.clear();
+    scratch.openQueue.clear();
+    scratch.reset(g_cols_ * g_rows_);
+    scratch.reusedNodes = 0;
 
     // Add start node to open list
-    Node *start = newNode(start_i, start_j, 0, 0, 0, nullptr);
-    openList_[index(start_i, start_j)] = start;
-    openQueue_.push(start);
+    // Its heuristic lets bestNode move off the start as the search closes in
+    float start_h = heuristic_(start_i, start_j, end_i, end_j, scratch.diagonal);
+    Node *start = scratch.newNode(start_i, start_j, 0, start_h, start_h, nullptr);
+    scratch.openList[index(start_i, start_j)] = start;
+    scratch.openStamp[index(start_i, start_j)] = scratch.generation;
+    scratch.openQueue.push(start);
+
+    return true;
+}
 
+SearchStatus Pathfinder::stepSearch_(const int &nodeBudget, SearchScratch &scratch) const
+{
     Node *currentNode;
-    float child_g, child_h, child_f;
-    int currentNodeIndex, child_i, child_j, childIndex;
-    int endIndex = index(end_i, end_j);
-    reusedNodes_ = 0;
-    Node *newChild;
-    std::unordered_map<int, bool>::iterator closedSearch;
-    std::unordered_map<int, Node *>::iterator foundNode;
-    while (!openQueue_.empty())
+    int currentNodeIndex;
+    int endIndex = index(scratch.end_i, scratch.end_j);
+    int expanded = 0;
+    while (!scratch.openQueue.empty())
     {
-        runs_ += 1;
+        if (expanded >= nodeBudget)
+            return SEARCH_IN_PROGRESS;
+        expanded += 1;
+
+        scratch.runs += 1;
 
         // Pop the openNode with lowest f
-        currentNode = openQueue_.top();
-        openQueue_.pop();
+        currentNode = scratch.openQueue.pop();
         currentNodeIndex = index(currentNode->i, currentNode->j);
 
         // Make sure current node has not been closed yet
-        closedSearch = closedList_.find(currentNodeIndex);
-        if (closedSearch == closedList_.end())
+        if (scratch.isClosed(currentNodeIndex))
+            continue;
+
+        scratch.closedStamp[currentNodeIndex] = scratch.generation;
+
+        if (scratch.bestNode == nullptr || currentNode->h < scratch.bestNode->h)
+            scratch.bestNode = currentNode;
+
+        if (currentNodeIndex == endIndex)
+        {
+            scratch.goalNode = currentNode;
+            scratch.cleanUp();
+            return SEARCH_FOUND;
+        }
+
+        if (scratch.jps)
+            expandJPS_(currentNode, scratch);
+        else
+            expandAStar_(currentNode, scratch);
+    }
+
+    scratch.cleanUp();
+    return SEARCH_NOT_FOUND;
+}
+
+void Pathfinder::expandAStar_(Node *currentNode, SearchScratch &scratch) const
+{
+    float child_g, child_h, child_f;
+    int child_i, child_j, childIndex;
+    Node *newChild;
+    Node *foundNode;
+
+    // Look at all adjacent nodes
+    for (int ci = -1; ci < 2; ci++)
+    {
+        for (int cj = -1; cj < 2; cj++)
         {
-            closedList_[currentNodeIndex] = true;
+            if (!validAdjacent_(ci, cj, currentNode->i, currentNode->j, scratch.diagonal))
+                continue;
 
-            if (currentNodeIndex == endIndex)
+            child_i = currentNode->i + ci;
+            child_j = currentNode->j + cj;
+            childIndex = index(child_i, child_j);
+
+            // Check to see if child node is closed
+            if (scratch.isClosed(childIndex))
+                continue;
+
+            child_g = currentNode->g + stepCost(currentNode->i, currentNode->j, ci, cj);
+            child_h = heuristic_(child_i, child_j, scratch.end_i, scratch.end_j, scratch.diagonal);
+            child_f = child_g + child_h;
+            if (!scratch.isOpen(childIndex))
+            {
+                // Add child node to open list
+                newChild = scratch.newNode(
+                    child_i,
+                    child_j,
+                    child_g,
+                    child_h,
+                    child_f,
+                    currentNode);
+                scratch.openList[childIndex] = newChild;
+                scratch.openStamp[childIndex] = scratch.generation;
+                scratch.openQueue.push(newChild);
+            }
+            else
             {
-                // Reached the end backtrack and build the path from currentNode
-                while (currentNode != nullptr)
+                foundNode = scratch.openList[childIndex];
+                if (foundNode->g > child_g)
                 {
-                    resultPath.insert(resultPath.begin(), std::pair<int, int>(currentNode->i, currentNode->j));
-                    currentNode = currentNode->parent;
+                    // if current child is furthur from origin than the one in
+                    // the open list, switch to current child
+                    foundNode->g = child_g;
+                    foundNode->h = child_h;
+                    foundNode->f = child_f;
+                    foundNode->parent = currentNode;
+                    scratch.openQueue.decreaseKey(foundNode);
+                    scratch.reusedNodes += 1;
                 }
+            }
+        }
+    }
+}
 
-                cleanUp();
-                return true;
+void Pathfinder::expandJPS_(Node *currentNode, SearchScratch &scratch) const
+{
+    /**
+     * Jump Point Search over the 8-connected grid, straight steps cost 1 and
+     * diagonal steps sqrt(2). Diagonal moves follow the same rule as
+     * validAdjacent_, both orthogonal neighbours must be free, so the
+     * pruning rules are the "no corner cutting" variant.
+     **/
+    int end_i = scratch.end_i;
+    int end_j = scratch.end_j;
+    int i = currentNode->i;
+    int j = currentNode->j;
+
+    if (currentNode->parent == nullptr)
+    {
+        // Start node, all neighbours are natural
+        for (int ci = -1; ci < 2; ci++)
+        {
+            for (int cj = -1; cj < 2; cj++)
+            {
+                if (validAdjacent_(ci, cj, i, j, true))
+                    addJumpSuccessor_(currentNode, ci, cj, end_i, end_j, scratch);
             }
+        }
+        return;
+    }
+
+    int d_i = (i > currentNode->parent->i) - (i < currentNode->parent->i);
+    int d_j = (j > currentNode->parent->j) - (j < currentNode->parent->j);
 
-            // Look at all adjacent nodes
-            for (int ci = -1; ci < 2; ci++)
+    if (d_i != 0 && d_j != 0)
+    {
+        bool freeI = passableCell(i + d_i, j);
+        bool freeJ = passableCell(i, j + d_j);
+        if (freeJ)
+            addJumpSuccessor_(currentNode, 0, d_j, end_i, end_j, scratch);
+        if (freeI)
+            addJumpSuccessor_(currentNode, d_i, 0, end_i, end_j, scratch);
+        if (freeI && freeJ)
+            addJumpSuccessor_(currentNode, d_i, d_j, end_i, end_j, scratch);
+    }
+    else if (d_i != 0)
+    {
+        bool freeNext = passableCell(i + d_i, j);
+        bool freeUp = passableCell(i, j - 1);
+        bool freeDown = passableCell(i, j + 1);
+        if (freeNext)
+        {
+            addJumpSuccessor_(currentNode, d_i, 0, end_i, end_j, scratch);
+            if (freeUp)
+                addJumpSuccessor_(currentNode, d_i, -1, end_i, end_j, scratch);
+            if (freeDown)
+                addJumpSuccessor_(currentNode, d_i, 1, end_i, end_j, scratch);
+        }
+        if (freeUp)
+            addJumpSuccessor_(currentNode, 0, -1, end_i, end_j, scratch);
+        if (freeDown)
+            addJumpSuccessor_(currentNode, 0, 1, end_i, end_j, scratch);
+    }
+    else
+    {
+        bool freeNext = passableCell(i, j + d_j);
+        bool freeLeft = passableCell(i - 1, j);
+        bool freeRight = passableCell(i + 1, j);
+        if (freeNext)
+        {
+            addJumpSuccessor_(currentNode, 0, d_j, end_i, end_j, scratch);
+            if (freeLeft)
+                addJumpSuccessor_(currentNode, -1, d_j, end_i, end_j, scratch);
+            if (freeRight)
+                addJumpSuccessor_(currentNode, 1, d_j, end_i, end_j, scratch);
+        }
+        if (freeLeft)
+            addJumpSuccessor_(currentNode, -1, 0, end_i, end_j, scratch);
+        if (freeRight)
+            addJumpSuccessor_(currentNode, 1, 0, end_i, end_j, scratch);
+    }
+}
+
+void Pathfinder::buildPath_(const Node *node, std::vector<std::pair<int, int>> &resultPath) const
+{
+    // Jump points are joined by straight or diagonal runs, fill in the
+    // cells between them so JPS paths match searchAStar's. A* parents
+    // are always adjacent so this just walks the chain
+    int first = resultPath.size();
+    while (node->parent != nullptr)
+    {
+        const Node *parent = node->parent;
+        int d_i = (parent->i > node->i) - (parent->i < node->i);
+        int d_j = (parent->j > node->j) - (parent->j < node->j);
+        int i = node->i;
+        int j = node->j;
+        while (i != parent->i || j != parent->j)
+        {
+            resultPath.push_back(std::pair<int, int>(i, j));
+            i += d_i;
+            j += d_j;
+        }
+        node = parent;
+    }
+    resultPath.push_back(std::pair<int, int>(node->i, node->j));
+    std::reverse(resultPath.begin() + first, resultPath.end());
+}
+
+void Pathfinder::addJumpSuccessor_(Node *parent, const int &d_i, const int &d_j,
+                                   const int &end_i, const int &end_j,
+                                   SearchScratch &scratch) const
+{
+    int jump_i, jump_j;
+    if (!jump_(parent->i + d_i, parent->j + d_j, d_i, d_j, end_i, end_j, jump_i, jump_j))
+        return;
+
+    int jumpIndex = index(jump_i, jump_j);
+    if (scratch.isClosed(jumpIndex))
+        return;
+
+    // Octile distance, the run to a jump point is straight or diagonal
+    int di = abs(jump_i - parent->i);
+    int dj = abs(jump_j - parent->j);
+    float g = parent->g + (float)std::max(di, dj) + (M_SQRT2 - 1.f) * (float)std::min(di, dj);
+
+    float h = heuristic_(jump_i, jump_j, end_i, end_j, true);
+
+    if (!scratch.isOpen(jumpIndex))
+    {
+        Node *jumpNode = scratch.newNode(jump_i, jump_j, g, h, g + h, parent);
+        scratch.openList[jumpIndex] = jumpNode;
+        scratch.openStamp[jumpIndex] = scratch.generation;
+        scratch.openQueue.push(jumpNode);
+        return;
+    }
+
+    Node *jumpNode = scratch.openList[jumpIndex];
+    if (jumpNode->g > g)
+    {
+        jumpNode->g = g;
+        jumpNode->f = g + jumpNode->h;
+        jumpNode->parent = parent;
+        scratch.openQueue.decreaseKey(jumpNode);
+        scratch.reusedNodes += 1;
+    }
+}
+
+float Pathfinder::heuristic_(const int &i, const int &j,
+                             const int &end_i, const int &end_j,
+                             const bool &diagonal) const
+{
+    int di = abs(end_i - i);
+    int dj = abs(end_j - j);
+
+    if (!diagonal)
+    {
+        // Manhattan
+        return heuristicWeight_ * (float)(di + dj);
+    }
+
+    // Octile, straight steps cost 1 and diagonal steps sqrt(2)
+    return heuristicWeight_ * ((float)std::max(di, dj) + (M_SQRT2 - 1.f) * (float)std::min(di, dj));
+}
+
+bool Pathfinder::jump_(int i, int j, const int &d_i, const int &d_j,
+                       const int &end_i, const int &end_j,
+                       int &out_i, int &out_j) const
+{
+    int ignore_i, ignore_j;
+    while (passableCell(i, j))
+    {
+        if (i == end_i && j == end_j)
+        {
+            out_i = i;
+            out_j = j;
+            return true;
+        }
+
+        if (d_i != 0 && d_j != 0)
+        {
+            // A diagonal run stops where a straight run from it finds something
+            if (jump_(i + d_i, j, d_i, 0, end_i, end_j, ignore_i, ignore_j) ||
+                jump_(i, j + d_j, 0, d_j, end_i, end_j, ignore_i, ignore_j))
             {
-                for (int cj = -1; cj < 2; cj++)
-                {
-                    if (validAdjacent_(ci, cj, currentNode->i, currentNode->j, diagonal))
-                    {
-                        child_i = currentNode->i + ci;
-                        child_j = currentNode->j + cj;
-                        childIndex = index(child_i, child_j);
-                        // Check to see if child node is closed
-                        closedSearch = closedList_.find(childIndex);
-                        if (closedSearch == closedList_.end())
-                        {
-                            child_g = currentNode->g + 1;
-                            child_h = (end_i - child_i) * (end_i - child_i) + (end_j - child_j) * (end_j - child_j);
-                            child_f = child_g + child_h;
-                            foundNode = openList_.find(childIndex);
-                            if (foundNode == openList_.end())
-                            {
-                                // Add child node to open list
-                                newChild = newNode(
-                                    child_i,
-                                    child_j,
-                                    child_g,
-                                    child_h,
-                                    child_f,
-                                    currentNode);
-                                openList_[index(child_i, child_j)] = newChild;
-                                openQueue_.push(newChild);
-                            }
-                            else
-                            {
-                                if (foundNode->second->g > child_g)
-                                {
-                                    // if current child is furthur from origin than the one in
-                                    // the open list, switch to current child
-                                    foundNode->second->g = child_g;
-                                    foundNode->second->h = child_h;
-                                    foundNode->second->f = child_f;
-                                    foundNode->second->parent = currentNode;
-                                    openQueue_.push(foundNode->second);
-                                    reusedNodes_ += 1;
-                                }
-                            }
-                        }
-                    }
-                }
+                out_i = i;
+                out_j = j;
+                return true;
+            }
+        }
+        else if (d_i != 0)
+        {
+            // Forced neighbours, a cell beside us that was blocked beside the previous cell
+            if ((passableCell(i, j - 1) && !passableCell(i - d_i, j - 1)) ||
+                (passableCell(i, j + 1) && !passableCell(i - d_i, j + 1)))
+            {
+                out_i = i;
+                out_j = j;
+                return true;
+            }
+        }
+        else
+        {
+            if ((passableCell(i - 1, j) && !passableCell(i - 1, j - d_j)) ||
+                (passableCell(i + 1, j) && !passableCell(i + 1, j - d_j)))
+            {
+                out_i = i;
+                out_j = j;
+                return true;
             }
         }
+
+        // Same corner cutting rule as validAdjacent_
+        if (!(passableCell(i + d_i, j) && passableCell(i, j + d_j)))
+            return false;
+
+        i += d_i;
+        j += d_j;
+    }
+
+    return false;
+}
+
+bool Pathfinder::lineOfSight(const int &start_i, const int &start_j,
+                             const int &end_i, const int &end_j) const
+{
+    /**
+     * Supercover walk, every cell the line between the two cell centres
+     * touches has to be valid. Where the line passes exactly through a
+     * corner both cells beside it are checked, like validAdjacent_.
+     **/
+    int n_i = abs(end_i - start_i);
+    int n_j = abs(end_j - start_j);
+    int s_i = (end_i > start_i) - (end_i < start_i);
+    int s_j = (end_j > start_j) - (end_j < start_j);
+
+    int i = start_i;
+    int j = start_j;
+
+    if (!passableCell(i, j))
+        return false;
+
+    int step_i = 0;
+    int step_j = 0;
+    while (step_i < n_i || step_j < n_j)
+    {
+        int decision = (1 + 2 * step_i) * n_j - (1 + 2 * step_j) * n_i;
+        if (decision == 0)
+        {
+            if (!(passableCell(i + s_i, j) && passableCell(i, j + s_j)))
+                return false;
+            i += s_i;
+            j += s_j;
+            step_i++;
+            step_j++;
+        }
+        else if (decision < 0)
+        {
+            i += s_i;
+            step_i++;
+        }
+        else
+        {
+            j += s_j;
+            step_j++;
+        }
+
+        if (!passableCell(i, j))
+            return false;
+    }
+
+    return true;
+}
+
+void Pathfinder::smoothPath(const std::vector<std::pair<int, int>> &path,
+                            std::vector<std::pair<int, int>> &resultPath) const
+{
+    resultPath.clear();
+
+    if (path.size() < 3)
+    {
+        resultPath = path;
+        return;
+    }
+
+    // Keep a waypoint only where the path bends around something
+    int anchor = 0;
+    resultPath.push_back(path[anchor]);
+    for (int n = 2; n < path.size(); n++)
+    {
+        if (!lineOfSight(path[anchor].first, path[anchor].second, path[n].first, path[n].second))
+        {
+            anchor = n - 1;
+            resultPath.push_back(path[anchor]);
+        }
     }
+    resultPath.push_back(path.back());
+}
+
+int Pathfinder::clearance(const int &i, const int &j) const
+{
+    return validCell(i, j) ? MAX_CLEARANCE : 0;
+}
 
-    cleanUp();
+bool Pathfinder::rowFree(const int &j, const int &start_i, const int &end_i) const
+{
+    for (int i = start_i; i < end_i; i++)
+    {
+        if (!validCell(i, j))
+            return false;
+    }
+    return true;
+}
+
+bool Pathfinder::rowHasFree(const int &j, const int &start_i, const int &end_i) const
+{
+    for (int i = start_i; i < end_i; i++)
+    {
+        if (validCell(i, j))
+            return true;
+    }
     return false;
 }
 
@@ -243,53 +830,59 @@ bool Pathfinder::validAdjacent_(const int &i, const int &j,
     if (!(abs(i) || abs(j)))
         return false;
 
-    if (!validCell(i + center_i, j + center_j))
+    if (!diagonal && i != 0 && j != 0)
         return false;
 
-    if ((abs(i) != abs(j)))
-    {
-        return true;
-    }
+    return stepCost(center_i, center_j, i, j) != std::numeric_limits<float>::infinity();
+}
 
-    if (!diagonal)
-    {
-        return false;
-    }
+Node *SearchScratch::newNode(const int &I, const int &J,
+                             const float &G, const float &H, const float &F,
+                             Node *Parent)
+{
+    Node *n = &nodePool[nodePoolUsed];
+    nodePoolUsed += 1;
 
-    int adj_i = i + (0 - i) + center_i;
-    int adj_j = j + center_j;
-    if (!validCell(adj_i, adj_j))
-    {
+    n->i = I;
+    n->j = J;
+    n->g = G;
+    n->h = H;
+    n->f = F;
+    n->parent = Parent;
+    n->heapIndex = -1;
 
-        return false;
-    }
+    return n;
+}
 
-    adj_i = i + center_i;
-    adj_j = j + (0 - j) + center_j;
-    if (!validCell(adj_i, adj_j))
+void SearchScratch::reset(const int &cells)
+{
+    // Only allocates on the first search, after that everything is reused
+    if (nodePool.size() != cells)
     {
-
-        return false;
+        nodePool.resize(cells);
+        openQueue.reserve(cells);
+        openList.resize(cells);
+        openStamp.assign(cells, 0);
+        closedStamp.assign(cells, 0);
+        generation = 0;
     }
 
-    return true;
-}
+    nodePoolUsed = 0;
 
-Node *Pathfinder::newNode(const int &I, const int &J,
-                          const float &G, const float &H, const float &F,
-                          Node *Parent)
-{
-    Node *n = new Node(I, J, G, H, F, Parent);
-    nodeList_.push_back(n);
-    return n;
+    generation += 1;
+    if (generation == 0)
+    {
+        // Stamps wrapped around, old stamps could alias the new generation
+        std::fill(openStamp.begin(), openStamp.end(), 0);
+        std::fill(closedStamp.begin(), closedStamp.end(), 0);
+        generation = 1;
+    }
 }
 
-void Pathfinder::cleanUp()
+void SearchScratch::cleanUp()
 {
-    nodesUsed_ = nodeList_.size();
-    for (auto &node : nodeList_)
-        delete node;
-    nodeList_.clear();
+    nodesUsed = nodePoolUsed;
+    nodePoolUsed = 0;
 }
 
 void Pathfinder::toGridCoord(const Vector3f &point, int &out_i, int &out_j) const
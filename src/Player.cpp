@@ -7,6 +7,9 @@ STATE_INSTANCE_INIT(Player, PlayerWalkState);
 STATE_INSTANCE_INIT(Player, PlayerJumpState);
 STATE_INSTANCE_INIT(Player, PlayerAttackingState);
 
+// Blocked this many times on one walk, the walk gives up
+const int MAX_REPAIRS = 8;
+
 Player::Player(ResourceManager &rm) : AnimatedEntity(rm),
                                       statemachine_(
                                           this,
@@ -44,8 +47,13 @@ Player::Player(ResourceManager &rm) : AnimatedEntity(rm),
 
 void Player::update(sf::Time &elapsed, World &world)
 {
+    Vector3f lastPosition = getPosition();
+
     statemachine_.updateState(elapsed, world);
 
+    if (elapsed.asSeconds() > 0)
+        velocity_ = (getPosition() - lastPosition) / elapsed.asSeconds();
+
     animate(elapsed);
 }
 
@@ -322,21 +330,21 @@ STATE_UPDATE_FUNCTION(Player, PlayerJumpState, World, world)
     return nullptr;
 }
 
+// Paths start where the search started, drop the points already walked past
+// while following a partial path
+static void skipWalkedPoints(const Vector3f &position, std::deque<Vector3f> &path)
+{
+    while (path.size() > 1 && vecDistance2(position, path[1]) < vecDistance2(path[0], path[1]))
+        path.pop_front();
+}
+
 STATE_ENTER_FUNCTION(Player, PlayerWalkToState, World, world)
 {
-    std::cout << "Finding Path.." << std::flush;
+    // The search runs on a worker thread, keep animating until it is done
     t->walkPath_.clear();
-    bool found = world.findPath(
-        *t,
-        t->walkTarget_,
-        true,
-        t->walkPath_);
-    if (!found)
-    {
-        std::cout << "Not found\n";
-        return;
-    }
-    std::cout << "Found\n";
+    t->repairs_ = 0;
+    t->pathRequest_ = world.requestPath(*t, t->walkTarget_, true, SEARCH_JPS);
+
     if (t->inWater)
     {
         t->setAnimationAction("swimming");
@@ -352,35 +360,60 @@ STATE_UPDATE_FUNCTION(Player, PlayerWalkToState, World, world)
         switch (event)
         {
         case PLAYER_STOP:
+            if (t->pathRequest_ != nullptr)
+                t->pathRequest_->cancel();
+            t->pathRequest_ = nullptr;
             return STATE(Player, PlayerIdleState);
             break;
         case PLAYER_WALK_TARGET:
-            std::cout << "Recalc Path.." << std::flush;
-            t->walkPath_.clear();
-            bool found = world.findPath(
-                *t,
-                t->walkTarget_,
-                true,
-                t->walkPath_);
-            if (!found)
-            {
-                std::cout << "Not found\n";
-            }
-            else
-            {
-                std::cout << "Found\n";
-            }
+            // Keep walking the current path until the new one arrives
+            t->pathRequest_ = world.requestPath(*t, t->walkTarget_, true, SEARCH_JPS);
             break;
         }
     }
 
+    if (t->pathRequest_ != nullptr && t->pathRequest_->isReady())
+    {
+        if (t->pathRequest_->isFound())
+        {
+            t->walkPath_ = t->pathRequest_->getPath();
+            skipWalkedPoints(t->getPosition(), t->walkPath_);
+        }
+        else
+        {
+            std::cout << "Path not found\n";
+            t->walkPath_.clear();
+        }
+        t->pathRequest_ = nullptr;
+
+        if (t->walkPath_.empty())
+            return STATE(Player, PlayerIdleState);
+    }
+
     if (t->walkPath_.empty())
     {
-        return STATE(Player, PlayerIdleState);
+        if (t->pathRequest_ != nullptr)
+        {
+            // Head towards the best cell found so far while the search runs
+            if (t->pathRequest_->takePartialPath(t->walkPath_))
+                skipWalkedPoints(t->getPosition(), t->walkPath_);
+            if (t->walkPath_.empty())
+                return nullptr;
+        }
+        else
+        {
+            // Paths to far away targets are refined a few cells at a time
+            if (world.sameGridCell(t->getPosition(), t->walkTarget_))
+                return STATE(Player, PlayerIdleState);
+
+            t->pathRequest_ = world.requestPath(*t, t->walkTarget_, true, SEARCH_JPS);
+            return nullptr;
+        }
     }
 
     float stepSize = t->walkSpeed_ * 60.f * elapsed.asSeconds();
     Vector3f position;
+    bool reached = false;
 
     float distance2 = vecMagnitude2(t->toLocal(t->walkPath_.front()) - t->getLocalPosition());
     if (distance2 > stepSize * stepSize)
@@ -394,26 +427,28 @@ STATE_UPDATE_FUNCTION(Player, PlayerWalkToState, World, world)
     else
     {
         position = t->toLocal(t->walkPath_.front());
-        t->walkPath_.pop_front();
+        reached = true;
     }
 
     if (!world.canMoveTo(*t, position))
     {
-        // walkPath_.clear();
-        // bool found = world.findPath(
-        //     *this,
-        //     walkTarget_,
-        //     true,
-        //     walkPath_);
-        // if (!found)
-        // {
-        //     std::cout << "Not found\n";
-        //     return idleStateId;
-        // }
-        // return walkStateId;
-        return STATE(Player, PlayerIdleState);
+        // Walk around whatever is in the way instead of giving up, unless
+        // repairs keep running into it
+        t->repairs_ += 1;
+        Vector3f goal = t->walkPath_.empty() ? t->walkTarget_ : t->walkPath_.back();
+        if (t->repairs_ > MAX_REPAIRS ||
+            !world.repairPath(*t, goal, t->getOrigin() + position, t->walkPath_))
+        {
+            std::cout << "Path blocked\n";
+            t->walkPath_.clear();
+            return STATE(Player, PlayerIdleState);
+        }
+        return nullptr;
     }
 
+    if (reached)
+        t->walkPath_.pop_front();
+
     t->setLocalPosition(position);
 
     return nullptr;
@@ -425,7 +460,7 @@ STATE_ENTER_FUNCTION(Player, PlayerAttackingState, World, world)
         return;
 
     float d = t->getSizeRadius() + t->attackingTarget_->getSizeRadius();
-    if (vecDistance2(t->getLocalPosition(), t->attackingTarget_->getLocalPosition()) > d * d)
+    if (vecDistance2(t->getPosition(), t->attackingTarget_->getPosition()) > d * d)
     {
         // t->walkTarget_ = t->attackingTarget_->getPosition();
         if (world.findNearbyFreePosition(t->attackingTarget_->getPosition(), t->walkTarget_))
@@ -441,10 +476,11 @@ STATE_UPDATE_FUNCTION(Player, PlayerAttackingState, World, world)
         return STATE(Player, PlayerIdleState);
 
     float d = t->getSizeRadius() + t->attackingTarget_->getSizeRadius();
-    if (vecDistance2(t->getLocalPosition(), t->attackingTarget_->getLocalPosition()) > d * d)
+    if (vecDistance2(t->getPosition(), t->attackingTarget_->getPosition()) > d * d)
     {
-        CALL_STATE_UPDATE(PlayerWalkToState, world);
-        return nullptr;
+        // Give up when the walk does, instead of requesting paths forever
+        STATE_CLASS(Player) *next = CALL_STATE_UPDATE(PlayerWalkToState, world);
+        return next;
     }
 
     t->attackingTarget_->attack();
@@ -0,0 +1,127 @@
+#include "SpatialHash.hpp"
+
+SpatialHash::SpatialHash(const float &bucketSize) : bucketSize_(bucketSize),
+                                                     maxHalfSize_(0)
+{
+}
+
+void SpatialHash::insert(Entity *entity)
+{
+    if (contains(entity))
+    {
+        update(entity);
+        return;
+    }
+
+    long long key = key_(entity->getLocalPosition());
+    grid_[key].push_back(entity);
+    buckets_[entity] = key;
+
+    // Never shrinks, so queries may look a little wider than needed
+    maxHalfSize_ = std::max(maxHalfSize_, entity->getSizeRadius());
+}
+
+void SpatialHash::remove(Entity *entity)
+{
+    auto search = buckets_.find(entity);
+    if (search == buckets_.end())
+        return;
+
+    unlink_(entity, search->second);
+    buckets_.erase(search);
+}
+
+void SpatialHash::update(Entity *entity)
+{
+    auto search = buckets_.find(entity);
+    if (search == buckets_.end())
+        return;
+
+    maxHalfSize_ = std::max(maxHalfSize_, entity->getSizeRadius());
+
+    long long key = key_(entity->getLocalPosition());
+    if (key == search->second)
+        return;
+
+    unlink_(entity, search->second);
+    grid_[key].push_back(entity);
+    search->second = key;
+}
+
+void SpatialHash::clear()
+{
+    grid_.clear();
+    buckets_.clear();
+    maxHalfSize_ = 0;
+}
+
+template <typename Test>
+void SpatialHash::query_(const Vector3f &localPoint, const float &halfWidth, const float &halfHeight,
+                         std::vector<Entity *> &out_entities, Test test) const
+{
+    // Entities are bucketed by their center, so anything reaching into the
+    // area has its center within the largest half size of it
+    int min_i = toBucket_(localPoint.x - halfWidth - maxHalfSize_);
+    int max_i = toBucket_(localPoint.x + halfWidth + maxHalfSize_);
+    int min_j = toBucket_(localPoint.y - halfHeight - maxHalfSize_);
+    int max_j = toBucket_(localPoint.y + halfHeight + maxHalfSize_);
+
+    for (int j = min_j; j <= max_j; j++)
+    {
+        for (int i = min_i; i <= max_i; i++)
+        {
+            auto bucket = grid_.find(key_(i, j));
+            if (bucket == grid_.end())
+                continue;
+
+            for (auto &entity : bucket->second)
+            {
+                if (test(entity))
+                    out_entities.push_back(entity);
+            }
+        }
+    }
+}
+
+void SpatialHash::queryRect(const Vector3f &localPoint, const Vector3f &size,
+                            std::vector<Entity *> &out_entities) const
+{
+    query_(localPoint, size.x / 2.f, size.y / 2.f, out_entities,
+           [&localPoint, &size](Entity *entity)
+           { return entity->collision(localPoint, size); });
+}
+
+void SpatialHash::queryRadius(const Vector3f &localPoint, const float &radius,
+                              std::vector<Entity *> &out_entities) const
+{
+    query_(localPoint, radius, radius, out_entities,
+           [&localPoint, &radius](Entity *entity)
+           {
+               Vector3f d = entity->getLocalPosition() - localPoint;
+               float reach = radius + entity->getSizeRadius();
+               return d.x * d.x + d.y * d.y <= reach * reach;
+           });
+}
+
+long long SpatialHash::key_(const Vector3f &localPoint) const
+{
+    return key_(toBucket_(localPoint.x), toBucket_(localPoint.y));
+}
+
+void SpatialHash::unlink_(Entity *entity, const long long &key)
+{
+    auto bucket = grid_.find(key);
+    if (bucket == grid_.end())
+        return;
+
+    std::vector<Entity *> &entities = bucket->second;
+    auto found = std::find(entities.begin(), entities.end(), entity);
+    if (found != entities.end())
+    {
+        *found = entities.back();
+        entities.pop_back();
+    }
+
+    if (entities.empty())
+        grid_.erase(bucket);
+}
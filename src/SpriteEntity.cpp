@@ -23,6 +23,15 @@ void SpriteEntity::draw(sf::RenderTarget *screen)
     screen->draw(sprite_, transform_);
 }
 
+FloatRect SpriteEntity::getScreenBounds(const Camera &camera) const
+{
+    Vector3f screenPosition = camera.transform(getPosition());
+    Vector2f size = getSpriteSize();
+    return FloatRect(screenPosition.x - spriteOrigin_.x,
+                     screenPosition.y - spriteOrigin_.y,
+                     size.x, size.y);
+}
+
 void SpriteEntity::drawReflection(sf::RenderTarget *screen)
 {
     sf::Transform t = sf::Transform(1, 0, getScreenPosition().x,
@@ -54,19 +63,26 @@ FloatRect SpriteEntity::getSpriteRect() const
     return FloatRect(sprite_.getTextureRect());
 }
 
-bool SpriteEntity::loadSprite(std::string filename)
+bool SpriteEntity::loadSprite(std::string filename, const bool &deferTexture)
 {
     auto spriteFile = rm->loadConfig(filename);
 
     if (spriteFile == nullptr)
         return false;
 
-    auto texture = rm->loadTexture(spriteFile->getAsString("texture"));
+    if (deferTexture)
+    {
+        textureFile_ = spriteFile->getAsString("texture");
+    }
+    else
+    {
+        auto texture = rm->loadTexture(spriteFile->getAsString("texture"));
 
-    if (texture == nullptr)
-        return false;
+        if (texture == nullptr)
+            return false;
 
-    setTexture(texture);
+        setTexture(texture);
+    }
 
     setSpriteOrigin(
         spriteFile->getAsVector2f("origin").x,
@@ -76,3 +92,12 @@ bool SpriteEntity::loadSprite(std::string filename)
 
     return true;
 }
+
+void SpriteEntity::uploadTexture()
+{
+    if (textureFile_.empty())
+        return;
+
+    setTexture(rm->loadTexture(textureFile_));
+    textureFile_.clear();
+}
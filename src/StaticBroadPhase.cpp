@@ -0,0 +1,92 @@
+#include "StaticBroadPhase.hpp"
+
+StaticBroadPhase::StaticBroadPhase() : maxWidth_(0),
+                                       maxRadius_(0),
+                                       bounds_{0, 0, 0, 0, nullptr}
+{
+}
+
+void StaticBroadPhase::build(const std::vector<Entity *> &entities)
+{
+    boxes_.clear();
+    boxes_.reserve(entities.size());
+    maxWidth_ = 0;
+    maxRadius_ = 0;
+
+    for (auto &entity : entities)
+    {
+        Vector3f topLeft = entity->getLocalPosition() - (entity->getSize() / 2.f);
+        Box box{topLeft.x, topLeft.x + entity->getSize().x,
+                topLeft.y, topLeft.y + entity->getSize().y,
+                entity};
+
+        if (boxes_.empty())
+            bounds_ = box;
+        bounds_.left = std::min(bounds_.left, box.left);
+        bounds_.right = std::max(bounds_.right, box.right);
+        bounds_.top = std::min(bounds_.top, box.top);
+        bounds_.bottom = std::max(bounds_.bottom, box.bottom);
+
+        maxWidth_ = std::max(maxWidth_, box.right - box.left);
+        maxRadius_ = std::max(maxRadius_, entity->getSizeRadius());
+        boxes_.push_back(box);
+    }
+
+    std::sort(boxes_.begin(), boxes_.end(),
+              [](const Box &a, const Box &b)
+              { return a.left < b.left; });
+}
+
+void StaticBroadPhase::clear()
+{
+    boxes_.clear();
+    maxWidth_ = 0;
+    maxRadius_ = 0;
+}
+
+template <typename Test>
+void StaticBroadPhase::query_(const float &left, const float &right, const float &top, const float &bottom,
+                              std::vector<Entity *> &out_entities, Test test) const
+{
+    if (boxes_.empty() ||
+        left >= bounds_.right || right <= bounds_.left ||
+        top >= bounds_.bottom || bottom <= bounds_.top)
+        return;
+
+    // Only boxes starting less than the widest box to the left can reach
+    auto first = std::lower_bound(boxes_.begin(), boxes_.end(), left - maxWidth_,
+                                  [](const Box &box, const float &x)
+                                  { return box.left < x; });
+
+    for (auto box = first; box != boxes_.end() && box->left < right; ++box)
+    {
+        if (box->right > left && box->top < bottom && box->bottom > top && test(*box))
+            out_entities.push_back(box->entity);
+    }
+}
+
+void StaticBroadPhase::queryRect(const Vector3f &localPoint, const Vector3f &size,
+                                 std::vector<Entity *> &out_entities) const
+{
+    // Same overlap test as Entity::collision
+    query_(localPoint.x - size.x / 2.f, localPoint.x + size.x / 2.f,
+           localPoint.y - size.y / 2.f, localPoint.y + size.y / 2.f,
+           out_entities,
+           [](const Box &)
+           { return true; });
+}
+
+void StaticBroadPhase::queryRadius(const Vector3f &localPoint, const float &radius,
+                                   std::vector<Entity *> &out_entities) const
+{
+    // Any box within reach overlaps the square padded by the largest radius
+    query_(localPoint.x - radius - maxRadius_, localPoint.x + radius + maxRadius_,
+           localPoint.y - radius - maxRadius_, localPoint.y + radius + maxRadius_,
+           out_entities,
+           [&localPoint, &radius](const Box &box)
+           {
+               Vector3f d = box.entity->getLocalPosition() - localPoint;
+               float reach = radius + box.entity->getSizeRadius();
+               return d.x * d.x + d.y * d.y <= reach * reach;
+           });
+}
@@ -7,7 +7,9 @@ TropicalTree::TropicalTree(ResourceManager &rm, RandomGenerator &r) : SpriteEnti
     std::string filename = "graphics/sprites/_tree_" + n + "_" + std::to_string(r.randomInt(0, 7)) + "0000.sprite";
 
     // std::string filename = "graphics/sprites/_tree_01_00000.sprite";
-    loadSprite(filename);
+    // Trees are made by WorldCell::load() on the job pool, the cell
+    // uploads the texture once it is back on the main thread
+    loadSprite(filename, true);
 
     // setTexture(rm.loadTexture(filename));
 
@@ -1,5 +1,21 @@
 #include "World.hpp"
 
+// How far ahead of the player cells start loading, in seconds at its
+// current velocity and in cells along its walk path
+const float PREFETCH_SECONDS = 3.f;
+const float PREFETCH_PATH_CELLS = 0.5f;
+const int MAX_PREFETCH_CELLS = 3;
+
+// Around twenty cells, each ground texture alone is over 10 MB
+const std::size_t DEFAULT_CELL_CACHE_BUDGET = 256 * 1024 * 1024;
+
+// A few pathfinder cells across, larger than most entities
+const float ENTITY_BUCKET_SIZE = 40.f;
+
+// Part of an entity's size that collides with the grid and the trees, and
+// that paths are planned for. Movers collide with each other at full size
+const float FOOTPRINT_SCALE = 0.8f;
+
 World::World(sf::RenderWindow &window,
              ResourceManager &rm,
              int64_t width, int64_t height) : window_(&window),
@@ -14,6 +30,8 @@ World::World(sf::RenderWindow &window,
                                                                      10,
                                                                      window.getSize().x,
                                                                      window.getSize().y)),
+                                              culledCount_(0),
+                                              drawnCount_(0),
                                               worldConfig_(
                                                   4000000.f, 4000000.f,
                                                   10000, 10000,
@@ -22,18 +40,37 @@ World::World(sf::RenderWindow &window,
                                               player_(new Player(rm)),
                                               cursor_(rm),
                                               ocean_(rm),
+                                              entityHash_(ENTITY_BUCKET_SIZE),
                                               pathfinder_(
                                                   Vector3f(0, 0, 0),
                                                   worldConfig_),
+                                              hierarchicalPathfinder_(worldConfig_, cellCache_),
+                                              asyncPathfinder_(
+                                                  worldConfig_.getCellWidth() * 3.f,
+                                                  worldConfig_.getCellHeight() * 3.f,
+                                                  worldConfig_.subCols() * 3,
+                                                  worldConfig_.subRows() * 3),
+                                              replanner_(pathfinder_),
+                                              replannerClearance_(1),
+                                              failedStepsEnd_(-1, -1),
                                               pathfinderGrid_(pathfinder_),
                                               gridVisible_(false),
-                                              activeCellId_(-1)
+                                              visibleDirty_(true),
+                                              visibleRebuilds_(0),
+                                              visibleRebuildsPerSecond_(0),
+                                              rebuildTimer_(0),
+                                              activeCellId_(-1),
+                                              cellWindow_{nullptr},
+                                              cellCacheBudget_(DEFAULT_CELL_CACHE_BUDGET),
+                                              cellCacheBytes_(0)
 {
     ocean_.setSize(
         worldConfig_.getCellWidth() * 3.f,
         worldConfig_.getCellHeight() * 3.f,
         0);
 
+    pathfinder_.setSmoothPath(true);
+
     addEntity(player_);
 
     cursor_.setSize(Vector3f(5, 5, 5));
@@ -106,76 +143,313 @@ void World::updateCells_()
     std::cout << "Updating cells\n";
     activeCells_.clear();
 
+    int center_i = cellId % worldConfig_.cols();
+    int center_j = cellId / worldConfig_.cols();
+
+    // Prefetches that did not start and are not needed now, the ones
+    // still ahead are queued again by the next prefetchCells_()
+    std::vector<WorldCell *> cancelledCells;
+    for (auto &cell : prefetchedCells_)
+    {
+        if (cellPriority_(cell->geti(), cell->getj()) > 2)
+        {
+            cell->cancelLoad();
+            cancelledCells.push_back(cell);
+        }
+    }
+    prefetchedCells_.clear();
+
+    // Slots are indexed by cell coordinates mod 3, so when the window
+    // moves by one cell only the row or column it left is replaced. The
+    // centre comes first, then the sides, then the corners
+    int offsets[9][2] = {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+
     int min_i = worldConfig_.rows();
     int min_j = worldConfig_.cols();
-    int max_i = 0;
-    int max_j = 0;
-    for (auto [i, j] : worldConfig_.getAdjacentIds(player_->getPosition(), 9))
+    for (auto &offset : offsets)
     {
-        WorldCell *currentCell;
+        int i = center_i + offset[0];
+        int j = center_j + offset[1];
+        WorldCell *&slot = cellWindow_[(i % 3 + 3) % 3][(j % 3 + 3) % 3];
 
-        auto search = cellCache_.find(worldConfig_.getId(i, j));
-        if (search == cellCache_.end())
-        {
-            currentCell = new WorldCell(
-                *rm_,
-                worldConfig_,
-                i, j);
-            cellCache_[worldConfig_.getId(i, j)] = currentCell;
-        }
-        else
+        if (slot != nullptr && (slot->geti() != i || slot->getj() != j))
         {
-            currentCell = search->second;
+            // Scrolled out of range, maybe before it started loading
+            slot->cancelLoad();
+            touchCell_(worldConfig_.getId(slot->geti(), slot->getj()));
+            slot = nullptr;
         }
 
-        activeCells_.push_back(currentCell);
+        if (!worldConfig_.validCell(i, j))
+            continue;
+
+        if (slot == nullptr)
+            slot = getCell_(i, j);
+
+        // Queued loads move up as the player gets closer
+        slot->requestLoad(cellPriority_(i, j));
+
+        activeCells_.push_back(slot);
 
         if (i < min_i)
             min_i = i;
         if (j < min_j)
             min_j = j;
-        if (i > max_i)
-            max_i = i;
-        if (j > max_j)
-            max_j = j;
     }
 
+    // Cancelled before they loaded they count for no bytes, so the
+    // budget would never evict them
+    for (auto &cell : cancelledCells)
+    {
+        if (cell->getLoadState() == CELL_UNLOADED &&
+            std::find(activeCells_.begin(), activeCells_.end(), cell) == activeCells_.end())
+            removeCell_(worldConfig_.getId(cell->geti(), cell->getj()));
+    }
+
+    evictCells_();
+    visibleDirty_ = true;
+
     pathfinder_.setPosition(
         worldConfig_.getCellPosition(min_i, min_j));
 
     pathfinder_.setActiveCells(min_i, min_j, activeCells_);
+    resetReplanner_();
 
     ocean_.setPosition(pathfinder_.getPosition());
 
-    for (auto &cell : activeCells_)
-    {
-        cell->translateOrigin(pathfinder_.getPosition());
-    }
-
+    // Only entities that move and collide in the pathfinder's coordinates
+    // are rebased. Cell entities keep their own origin, they are drawn from
+    // their global position and Entity::collision converts between origins
+    // Every local position changed, so the hash is built again
+    entityHash_.clear();
     for (auto &entity : entities_)
     {
         entity->translateOrigin(pathfinder_.getPosition());
+        entityHash_.insert(entity);
     }
 
     cursor_.translateOrigin(pathfinder_.getPosition());
     // ocean_.translateOrigin(pathfinder_.getPosition());
 }
 
+void World::prefetchCells_()
+{
+    // Straight ahead at the current velocity, and along the walk path
+    std::vector<Vector3f> ahead;
+    ahead.push_back(player_->getPosition() + player_->getVelocity() * PREFETCH_SECONDS);
+
+    Vector3f last = player_->getPosition();
+    float remaining = worldConfig_.getCellWidth() * PREFETCH_PATH_CELLS;
+    for (auto &point : player_->getWalkPath())
+    {
+        float distance = vecDistance(last, point);
+        if (distance > remaining)
+        {
+            ahead.push_back(last + (point - last) * (remaining / distance));
+            break;
+        }
+        ahead.push_back(point);
+        remaining -= distance;
+        last = point;
+    }
+
+    // A few per update, so a turn does not flood the job pool with
+    // cells that get cancelled again
+    int requested = 0;
+    for (auto &point : ahead)
+    {
+        if (worldConfig_.getId(point) == activeCellId_)
+            continue;
+
+        for (auto [i, j] : worldConfig_.getAdjacentIds(point, 9))
+        {
+            // Only made once it is going to be requested
+            auto search = cellCache_.find(worldConfig_.getId(i, j));
+            if (search != cellCache_.end() && search->second->getLoadState() != CELL_UNLOADED)
+            {
+                touchCell_(search->first);
+                continue;
+            }
+
+            if (requested >= MAX_PREFETCH_CELLS)
+                return;
+
+            WorldCell *cell = getCell_(i, j);
+            cell->requestLoad(cellPriority_(i, j));
+            prefetchedCells_.push_back(cell);
+            requested += 1;
+        }
+    }
+}
+
+WorldCell *World::getCell_(const int &i, const int &j)
+{
+    int id = worldConfig_.getId(i, j);
+    touchCell_(id);
+
+    auto search = cellCache_.find(id);
+    if (search != cellCache_.end())
+        return search->second;
+
+    WorldCell *cell = new WorldCell(
+        *rm_,
+        worldConfig_,
+        jobPool_,
+        i, j);
+    cellCache_[id] = cell;
+    uncountedCells_.push_back(cell);
+    cellUsage_.push_front(id);
+    cellUsageIndex_[id] = cellUsage_.begin();
+    return cell;
+}
+
+void World::touchCell_(const int &id)
+{
+    auto usage = cellUsageIndex_.find(id);
+    if (usage != cellUsageIndex_.end())
+        cellUsage_.splice(cellUsage_.begin(), cellUsage_, usage->second);
+}
+
+void World::setCellCacheBudget(const std::size_t &bytes)
+{
+    cellCacheBudget_ = bytes;
+    evictCells_();
+}
+
+std::size_t World::getCellCacheBytes() const
+{
+    // Cells that finished loading since the last count
+    std::size_t bytes = cellCacheBytes_;
+    for (auto &cell : uncountedCells_)
+    {
+        if (cell->isLoaded())
+            bytes += cell->getMemory().total();
+    }
+    return bytes;
+}
+
+void World::countLoadedCells_()
+{
+    // Loading only ever finishes, so each cell is counted once
+    auto counted = std::remove_if(uncountedCells_.begin(), uncountedCells_.end(),
+                                  [this](WorldCell *cell)
+                                  {
+                                      if (!cell->isLoaded())
+                                          return false;
+                                      cellCacheBytes_ += cell->getMemory().total();
+                                      return true;
+                                  });
+    uncountedCells_.erase(counted, uncountedCells_.end());
+}
+
+void World::evictCells_()
+{
+    countLoadedCells_();
+
+    auto usage = cellUsage_.end();
+    while (cellCacheBytes_ > cellCacheBudget_ && usage != cellUsage_.begin())
+    {
+        --usage;
+        WorldCell *cell = cellCache_[*usage];
+
+        // The pathfinder holds on to active cells, and deleting a cell that
+        // is loading would wait for it here
+        if (cell->isLoading() ||
+            std::find(activeCells_.begin(), activeCells_.end(), cell) != activeCells_.end())
+            continue;
+
+        // Past the one being removed
+        int id = *usage;
+        ++usage;
+        removeCell_(id);
+    }
+}
+
+void World::removeCell_(const int &id)
+{
+    WorldCell *cell = cellCache_[id];
+
+    auto uncounted = std::find(uncountedCells_.begin(), uncountedCells_.end(), cell);
+    if (uncounted != uncountedCells_.end())
+        uncountedCells_.erase(uncounted);
+    else
+        cellCacheBytes_ -= cell->getMemory().total();
+
+    cellCache_.erase(id);
+    cellUsage_.erase(cellUsageIndex_[id]);
+    cellUsageIndex_.erase(id);
+    prefetchedCells_.erase(std::remove(prefetchedCells_.begin(), prefetchedCells_.end(), cell),
+                           prefetchedCells_.end());
+    delete cell;
+}
+
+int World::cellPriority_(const int &i, const int &j)
+{
+    // Squared distance from the player's cell, the cell under the player
+    // loads first, then its sides, then its corners
+    int cellId = worldConfig_.getId(player_->getPosition());
+    int di = i - cellId % worldConfig_.cols();
+    int dj = j - cellId / worldConfig_.cols();
+    return di * di + dj * dj;
+}
+
 void World::updateVisibileList_()
 {
+    // Generated cells get their textures on this thread, one per update
+    // so several cells finishing together do not stall a frame
+    for (auto &cell : activeCells_)
+    {
+        if (cell->getLoadState() == CELL_READY_TO_UPLOAD)
+        {
+            // Its entities replace the placeholder
+            visibleDirty_ = cell->upload() || visibleDirty_;
+            break;
+        }
+    }
+
+    if (!visibleDirty_)
+        return;
+
+    visibleDirty_ = false;
+    visibleRebuilds_ += 1;
+
     visibleEntities_.clear();
     floorEntities_.clear();
 
     visibleEntities_ = entities_;
     for (auto &cell : activeCells_)
     {
-        cell->translateOrigin(pathfinder_.getPosition());
         for (auto entity : cell->getEntities())
         {
             visibleEntities_.push_back(entity);
         }
         floorEntities_.push_back(cell->getFloor());
     }
+
+    // Culled in this order, so the drawn lists come out nearly sorted and
+    // only the entities that moved since need sorting each frame
+    sortByDepth_(visibleEntities_);
+    sortByDepth_(floorEntities_);
+}
+
+void World::sortByDepth_(std::vector<Entity *> &list)
+{
+    // Culled entities have stale screen positions, their depth is worked
+    // out afresh
+    depthKeys_.clear();
+    for (auto &entity : list)
+    {
+        depthKeys_.emplace_back(camera_->transform(entity->getPosition()).z, entity);
+    }
+
+    std::sort(depthKeys_.begin(), depthKeys_.end(),
+              [](const std::pair<float, Entity *> &a, const std::pair<float, Entity *> &b)
+              { return a.first < b.first; });
+
+    for (int n = 0; n < list.size(); n++)
+    {
+        list[n] = depthKeys_[n].second;
+    }
 }
 
 void World::update(sf::Time &elapsed)
@@ -183,8 +457,23 @@ void World::update(sf::Time &elapsed)
     ocean_.update(elapsed, *this);
 
     updateCells_();
+    prefetchCells_();
     updateVisibileList_();
 
+    rebuildTimer_ += elapsed.asSeconds();
+    if (rebuildTimer_ >= 1.f)
+    {
+        visibleRebuildsPerSecond_ = visibleRebuilds_ / rebuildTimer_;
+        visibleRebuilds_ = 0;
+        rebuildTimer_ = 0;
+    }
+
+    changedCells_.clear();
+    pathfinder_.collectChanges(changedCells_);
+    cacheFinishedPaths_();
+    if (!changedCells_.empty())
+        replanner_.updateCells(changedCells_, replannerClearance_);
+
     camera_->updateWindow(*window_);
 
     input_(elapsed);
@@ -194,9 +483,21 @@ void World::update(sf::Time &elapsed)
         entity->update(elapsed, *this);
     }
 
-    for (auto &entity : visibleEntities_)
+    // Only entities_ move and are in the hash, later ones in this update
+    // see where the earlier ones moved to
+    for (auto &entity : entities_)
     {
         entity->update(elapsed, *this);
+        entityHash_.update(entity);
+    }
+
+    // The rest of the visible list, the trees or placeholders of the cells
+    for (auto &cell : activeCells_)
+    {
+        for (auto &entity : cell->getEntities())
+        {
+            entity->update(elapsed, *this);
+        }
     }
 
     camera_->update(elapsed);
@@ -206,18 +507,16 @@ void World::transform()
 {
     ocean_.transform(*camera_);
 
-    for (auto &entity : floorEntities_)
-    {
-        entity->transform(*camera_);
-    }
+    FloatRect view = camera_->getViewRect();
+    culledCount_ = 0;
+    drawnCount_ = 0;
+
+    cull_(floorEntities_, view, drawnFloor_);
 
     if (gridVisible_)
         pathfinderGrid_.transform(*camera_);
 
-    for (auto &entity : visibleEntities_)
-    {
-        entity->transform(*camera_);
-    }
+    cull_(visibleEntities_, view, drawnEntities_);
 
     cursor_.transform(*camera_);
 }
@@ -228,9 +527,9 @@ void World::draw(sf::RenderTarget *screen)
 
     player_->drawReflection(screen);
 
-    std::sort(floorEntities_.begin(), floorEntities_.end(), entityDepthComp);
+    depthSort_(drawnFloor_);
 
-    for (auto &entity : floorEntities_)
+    for (auto &entity : drawnFloor_)
     {
         entity->draw(screen);
     }
@@ -238,9 +537,9 @@ void World::draw(sf::RenderTarget *screen)
     if (gridVisible_)
         pathfinderGrid_.draw(screen);
 
-    std::sort(visibleEntities_.begin(), visibleEntities_.end(), entityDepthComp);
+    depthSort_(drawnEntities_);
 
-    for (auto &entity : visibleEntities_)
+    for (auto &entity : drawnEntities_)
     {
         entity->draw(screen);
     }
@@ -251,9 +550,59 @@ void World::draw(sf::RenderTarget *screen)
 Entity *World::addEntity(Entity *entity)
 {
     entities_.push_back(entity);
+    entityHash_.insert(entity);
+    visibleDirty_ = true;
     return entity;
 }
 
+void World::removeEntity(Entity *entity)
+{
+    entities_.erase(std::remove(entities_.begin(), entities_.end(), entity), entities_.end());
+    entityHash_.remove(entity);
+    asyncPathfinder_.cancel(entity);
+    visibleDirty_ = true;
+}
+
+void World::depthSort_(std::vector<Entity *> &list)
+{
+    // The drawn lists are culled from depth sorted visible lists and only a
+    // few entities move, so an insertion sort over them is close to linear
+    for (int n = 1; n < list.size(); n++)
+    {
+        Entity *entity = list[n];
+        int m = n - 1;
+        while (m >= 0 && entityDepthComp(entity, list[m]))
+        {
+            list[m + 1] = list[m];
+            m--;
+        }
+        list[m + 1] = entity;
+    }
+}
+
+void World::cull_(const std::vector<Entity *> &list, const FloatRect &view,
+                  std::vector<Entity *> &out_drawn)
+{
+    out_drawn.clear();
+    for (auto &entity : list)
+    {
+        bool onScreen = view.intersects(entity->getScreenBounds(*camera_));
+
+        // The player's reflection is drawn even when it is off screen
+        if (onScreen || entity == player_)
+            entity->transform(*camera_);
+
+        if (!onScreen)
+        {
+            culledCount_ += 1;
+            continue;
+        }
+
+        out_drawn.push_back(entity);
+        drawnCount_ += 1;
+    }
+}
+
 void World::onMouseButtonReleased(const sf::Event &event)
 {
     // std::cout << "Mouse Release ";
@@ -261,19 +610,26 @@ void World::onMouseButtonReleased(const sf::Event &event)
     {
         // std::cout << "Left"
         //           << "\n";
-        for (auto &entity : visibleEntities_)
+        Entity *clicked = nullptr;
+
+        nearbyEntities_.clear();
+        queryEntities(cursor_.getPosition(), cursor_.getSize(), nearbyEntities_);
+        for (auto &entity : nearbyEntities_)
         {
             if (entity != player_)
             {
-                if (entity->collision(cursor_))
-                {
-                    std::cout << "clicked entity\n";
-                    std::cout << entity->getPosition() << "\n";
-                    player_->attackOther(*entity);
-                    return;
-                }
+                clicked = entity;
+                break;
             }
         }
+
+        if (clicked != nullptr)
+        {
+            std::cout << "clicked entity\n";
+            std::cout << clicked->getPosition() << "\n";
+            player_->attackOther(*clicked);
+            return;
+        }
         player_->walkTo(cursor_.getPosition());
         std::cout << "e" << worldConfig_.getElevation(cursor_.getPosition()) << "\n";
     }
@@ -316,6 +672,7 @@ void World::onKeyReleased(const sf::Event &event)
         {
             pathfinder_.setValidCellValue(1);
         }
+        resetReplanner_();
     }
 
     if (event.key.code == sf::Keyboard::W)
@@ -331,6 +688,7 @@ void World::onKeyReleased(const sf::Event &event)
         {
             pathfinder_.setValidCellValue(2);
         }
+        resetReplanner_();
     }
 
     if (event.key.code == sf::Keyboard::R)
@@ -346,7 +704,8 @@ const std::vector<Entity *> &World::getEntitys() const
 
 bool World::findPath(const Entity &entity, const Vector3f &end,
                      const bool &diagonal,
-                     std::deque<Vector3f> &resultPath)
+                     std::deque<Vector3f> &resultPath,
+                     const PathSearch &search)
 {
     // if (!canMoveTo(entity, entity.getLocalPosition()))
     // {
@@ -359,27 +718,283 @@ bool World::findPath(const Entity &entity, const Vector3f &end,
     //     std::cout << "\n";
     //     return false;
     // }
-    return pathfinder_.findPath(entity.getPosition(), end, diagonal, resultPath);
+    Vector3f pathEnd;
+    if (!pathEnd_(entity.getPosition(), end, pathEnd))
+        return false;
+
+    pathfinder_.setAgentClearance(agentClearance_(entity, pathEnd));
+    bool found = pathfinder_.findPath(entity.getPosition(), pathEnd, diagonal, resultPath, search);
+    pathfinder_.setAgentClearance(1);
+
+    return found;
 }
 
-bool World::canMoveTo(const Entity &entity, const Vector3f &localPoint) const
+std::shared_ptr<PathRequest> World::requestPath(const Entity &entity, const Vector3f &end,
+                                                const bool &diagonal,
+                                                const PathSearch &search)
+{
+    // Unreachable goals are rejected here rather than on the worker, the
+    // answer replaces the entity's previous request like a cached one
+    Vector3f pathEnd;
+    if (!pathEnd_(entity.getPosition(), end, pathEnd) ||
+        !pathfinder_.sameComponent(entity.getPosition(), pathEnd))
+        return asyncPathfinder_.finished(&entity, entity.getPosition(), end, diagonal, search, false, {});
+
+    pathfinder_.setAgentClearance(agentClearance_(entity, pathEnd));
+
+    // Repeated clicks and attacks on the same target are answered from the
+    // path cache, the rest are searched on the worker and cached when done
+    int start_i, start_j, end_i, end_j;
+    pathfinder_.toGridCoord(entity.getPosition(), start_i, start_j);
+    pathfinder_.toGridCoord(pathEnd, end_i, end_j);
+    uint64_t key = pathfinder_.getCacheKey(start_i, start_j, end_i, end_j, diagonal, search);
+
+    std::shared_ptr<PathRequest> request;
+    std::vector<std::pair<int, int>> cells;
+    bool found;
+    if (pathfinder_.validIndex(start_i, start_j) && pathfinder_.validIndex(end_i, end_j) &&
+        pathfinder_.findCachedPath(key, cells, found))
+    {
+        std::deque<Vector3f> path;
+        if (found)
+            pathfinder_.toPath(cells, path);
+        request = asyncPathfinder_.finished(&entity, entity.getPosition(), pathEnd, diagonal, search, found, path);
+    }
+    else
+    {
+        request = asyncPathfinder_.request(&entity, pathfinder_, entity.getPosition(), pathEnd, diagonal, search);
+        uncachedPaths_.push_back({request, key, pathfinder_.getHeuristicWeight(), pathfinder_.getVersion()});
+    }
+
+    pathfinder_.setAgentClearance(1);
+
+    return request;
+}
+
+void World::resetReplanner_()
 {
-    if (!pathfinder_.isAreaFree(localPoint, entity.getSize() * 0.8f))
+    // Grid coordinates or walkable cells changed
+    replanner_.reset();
+    failedSteps_.clear();
+    failedStepsEnd_ = std::pair<int, int>(-1, -1);
+}
+
+void World::cacheFinishedPaths_()
+{
+    for (int n = 0; n < uncachedPaths_.size();)
+    {
+        UncachedPath &uncached = uncachedPaths_[n];
+        PathRequestStatus status = uncached.request->getStatus();
+        if (status == PATH_PENDING)
+        {
+            n++;
+            continue;
+        }
+
+        if (status != PATH_CANCELLED)
+            pathfinder_.cachePath(uncached.key, uncached.heuristicWeight, uncached.version,
+                                  status == PATH_FOUND, uncached.request->getCells());
+
+        uncachedPaths_[n] = uncachedPaths_.back();
+        uncachedPaths_.pop_back();
+    }
+}
+
+int World::agentClearance_(const Entity &entity, const Vector3f &end) const
+{
+    // Same footprint canMoveTo checks
+    int needed = ClearanceMap::needed(entity.getSize().x * FOOTPRINT_SCALE, pathfinder_.getCellWidth());
+
+    // Already squeezed in somewhere narrow, or headed to such a place, plan
+    // for a point rather than not at all
+    int start_i, start_j, end_i, end_j;
+    pathfinder_.toGridCoord(entity.getPosition(), start_i, start_j);
+    pathfinder_.toGridCoord(end, end_i, end_j);
+    if (pathfinder_.clearance(start_i, start_j) < needed || pathfinder_.clearance(end_i, end_j) < needed)
+        return 1;
+
+    return needed;
+}
+
+bool World::pathEnd_(const Vector3f &start, const Vector3f &end, Vector3f &out_end)
+{
+    int end_i, end_j;
+    pathfinder_.toGridCoord(end, end_i, end_j);
+    if (pathfinder_.validIndex(end_i, end_j) || pathfinder_.getValidCellValue() != ONE)
+    {
+        out_end = end;
+        return true;
+    }
+
+    // The end is outside the active cells, plan across the abstract graph
+    // of all loaded cells and refine only the part inside the active cells.
+    // The entity plans again once it reaches the end of that part.
+    abstractPath_.clear();
+    if (!hierarchicalPathfinder_.findPath(start, end, abstractPath_))
         return false;
 
+    bool inside = false;
+    for (auto [i, j] : abstractPath_)
+    {
+        Vector3f point = hierarchicalPathfinder_.toPoint(i, j);
+        int window_i, window_j;
+        pathfinder_.toGridCoord(point, window_i, window_j);
+        if (!pathfinder_.validIndex(window_i, window_j))
+            break;
+        out_end = point;
+        inside = true;
+    }
+
+    return inside;
+}
+
+bool World::repairPath(const Entity &entity, const Vector3f &end,
+                       const Vector3f &blocked,
+                       std::deque<Vector3f> &resultPath)
+{
+    int start_i, start_j, end_i, end_j;
+    pathfinder_.toGridCoord(entity.getPosition(), start_i, start_j);
+    pathfinder_.toGridCoord(end, end_i, end_j);
+
+    // The search only carries over with the same clearance, and cells that
+    // stopped a step only count on the way to the same goal
+    int clearance = agentClearance_(entity, end);
+    if (clearance != replannerClearance_)
+    {
+        replanner_.reset();
+        replannerClearance_ = clearance;
+    }
+    if (failedStepsEnd_ != std::pair<int, int>(end_i, end_j))
+    {
+        failedSteps_.clear();
+        failedStepsEnd_ = std::pair<int, int>(end_i, end_j);
+    }
+
+    // Whatever stopped the step, a tree or too narrow a gap, blocks the
+    // cell stepped into. Steps are short, so within the start cell the
+    // blocked cell is the next one in that direction
+    int blocked_i, blocked_j;
+    pathfinder_.toGridCoord(blocked, blocked_i, blocked_j);
+    if (blocked_i == start_i && blocked_j == start_j)
+    {
+        Vector3f direction = blocked - entity.getPosition();
+        float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+        if (length > 0)
+            pathfinder_.toGridCoord(entity.getPosition() + direction * (pathfinder_.getCellWidth() / length),
+                                    blocked_i, blocked_j);
+    }
+    std::pair<int, int> failedStep(blocked_i, blocked_j);
+    if (std::find(failedSteps_.begin(), failedSteps_.end(), failedStep) == failedSteps_.end())
+        failedSteps_.push_back(failedStep);
+
+    // The other entities and every earlier failed step, only the cells
+    // whose blocking changed are handed to the replanner
+    std::vector<std::pair<int, int>> blockedCells;
     for (auto &e : entities_)
+    {
+        if (e == &entity)
+            continue;
+
+        Vector3f halfSize = (e->getSize() + entity.getSize()) / 2.f;
+        int min_i, min_j, max_i, max_j;
+        pathfinder_.toGridCoord(e->getPosition() - halfSize, min_i, min_j);
+        pathfinder_.toGridCoord(e->getPosition() + halfSize, max_i, max_j);
+        for (int i = min_i; i <= max_i; i++)
+        {
+            for (int j = min_j; j <= max_j; j++)
+                blockedCells.push_back(std::pair<int, int>(i, j));
+        }
+    }
+    blockedCells.insert(blockedCells.end(), failedSteps_.begin(), failedSteps_.end());
+    blockedCells.erase(std::remove_if(blockedCells.begin(), blockedCells.end(),
+                                      [&](const std::pair<int, int> &cell)
+                                      {
+                                          return (cell.first == start_i && cell.second == start_j) ||
+                                                 (cell.first == end_i && cell.second == end_j);
+                                      }),
+                       blockedCells.end());
+    replanner_.setBlockedCells(blockedCells);
+
+    pathfinder_.setAgentClearance(clearance);
+    std::vector<std::pair<int, int>> path;
+    bool found = replanner_.plan(start_i, start_j, end_i, end_j, path);
+    pathfinder_.setAgentClearance(1);
+
+    if (!found)
+        return false;
+
+    resultPath.clear();
+    for (int n = 1; n < path.size(); n++)
+    {
+        resultPath.push_back(pathfinder_.toPoint(path[n].first, path[n].second));
+    }
+
+    return true;
+}
+
+Vector3f World::flowDirection(const Entity &entity, const Vector3f &goal)
+{
+    int goal_i, goal_j;
+    pathfinder_.toGridCoord(goal, goal_i, goal_j);
+    if (!pathfinder_.validCell(goal_i, goal_j))
+        return Vector3f(0.f, 0.f, 0.f);
+
+    pathfinder_.setAgentClearance(agentClearance_(entity, goal));
+    Vector3f direction = pathfinder_.getFlowField(goal_i, goal_j).direction(entity.getPosition());
+    pathfinder_.setAgentClearance(1);
+
+    return direction;
+}
+
+bool World::sameGridCell(const Vector3f &a, const Vector3f &b) const
+{
+    int a_i, a_j, b_i, b_j;
+    hierarchicalPathfinder_.toGridCoord(a, a_i, a_j);
+    hierarchicalPathfinder_.toGridCoord(b, b_i, b_j);
+    return (a_i == b_i) && (a_j == b_j);
+}
+
+bool World::canMoveTo(const Entity &entity, const Vector3f &localPoint) const
+{
+    // The footprint the path was planned for, so planned paths stay free
+    Vector3f footprint = entity.getSize() * FOOTPRINT_SCALE;
+    if (!pathfinder_.isAreaFree(localPoint, footprint))
+        return false;
+
+    // Other movers at the full size, so they never overlap, and trees at
+    // the footprint like the grid
+    Vector3f point = entity.getOrigin() + localPoint;
+    nearbyEntities_.clear();
+    entityHash_.queryRect(point - pathfinder_.getPosition(), entity.getSize(), nearbyEntities_);
+    for (auto &cell : activeCells_)
+    {
+        if (cell->isReady())
+            cell->getBroadPhase().queryRect(point, footprint, nearbyEntities_);
+    }
+    for (auto &e : nearbyEntities_)
     {
         if (e != &entity)
         {
-            if (e->collision(localPoint, entity.getSize()))
-            {
-                return false;
-            }
+            return false;
         }
     }
     return true;
 }
 
+void World::queryEntities(const Vector3f &point, const Vector3f &size,
+                          std::vector<Entity *> &out_entities) const
+{
+    // entities_ share the pathfinder's origin, the trees have none
+    entityHash_.queryRect(point - pathfinder_.getPosition(), size, out_entities);
+
+    // Only once the trees are drawn, not while the placeholder is
+    for (auto &cell : activeCells_)
+    {
+        if (cell->isReady())
+            cell->getBroadPhase().queryRect(point, size, out_entities);
+    }
+}
+
 bool World::findNearbyFreePosition(const Vector3f &position, Vector3f &out_position)
 {
     return pathfinder_.findFreePosition(position, 9, out_position);
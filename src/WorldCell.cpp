@@ -2,6 +2,7 @@
 
 WorldCell::WorldCell(ResourceManager &rm,
                      WorldConfig &worldConfig,
+                     JobPool &jobPool,
                      const int &i, const int &j) : rm_(&rm),
                                                    worldConfig_(&worldConfig),
                                                    position_(worldConfig_->getCellPosition(i, j)),
@@ -10,17 +11,17 @@ WorldCell::WorldCell(ResourceManager &rm,
                                                    width_(worldConfig_->getCellWidth()),
                                                    height_(worldConfig_->getCellHeight()),
                                                    placeholder_(rm, worldConfig_->subRows(), worldConfig_->subCols()),
-                                                   loaded_(false),
                                                    floor_(nullptr),
                                                    obstacleGrid_(
                                                        worldConfig_->subCols(),
-                                                       worldConfig_->subRows())
+                                                       worldConfig_->subRows()),
+                                                   componentCount_{0, 0},
+                                                   memory_{0, 0, 0},
+                                                   jobPool_(&jobPool),
+                                                   loadState_(CELL_UNLOADED)
 {
     placeholder_.setPosition(position_);
     placeholders_.push_back(&placeholder_);
-
-    loadThread_ = std::thread(&WorldCell::load, this);
-    // loadThread_.join();
 }
 
 WorldCell::~WorldCell()
@@ -28,10 +29,10 @@ WorldCell::~WorldCell()
     // std::cout << "Destroying World Cell " << cell_i_ << ", " << cell_j_
     //           << "\n";
 
-    if (loadThread_.joinable())
-        loadThread_.join();
+    if (loadJob_ != nullptr && !jobPool_->cancel(loadJob_))
+        jobPool_->wait(loadJob_);
 
-    if (!loaded_)
+    if (!isLoaded())
         return;
 
     for (auto &entity : entities_)
@@ -51,6 +52,8 @@ int WorldCell::getId()
 
 void WorldCell::load()
 {
+    loadState_.store(CELL_GENERATING, std::memory_order_relaxed);
+
     obstacleGrid_.clear(1);
 
     RandomGenerator r(getId());
@@ -93,7 +96,118 @@ void WorldCell::load()
         }
     }
 
-    loaded_ = true;
+    // Trees never move, so they are sorted once here for collisions and
+    // picking
+    broadPhase_.build(entities_);
+
+    buildGrids_();
+
+    measureMemory_(*floor_);
+
+    // Everything above is visible to threads that see this state
+    loadState_.store(CELL_READY_TO_UPLOAD, std::memory_order_release);
+}
+
+void WorldCell::loadObstacles(const ValueGrid<int> &obstacles)
+{
+    loadState_.store(CELL_GENERATING, std::memory_order_relaxed);
+
+    for (int i = 0; i < obstacleGrid_.cols(); i++)
+    {
+        for (int j = 0; j < obstacleGrid_.rows(); j++)
+        {
+            obstacleGrid_.set(i, j, obstacles.validIndex(i, j) ? obstacles.value(i, j) : 0);
+        }
+    }
+
+    buildGrids_();
+
+    loadState_.store(CELL_READY_TO_UPLOAD, std::memory_order_release);
+}
+
+void WorldCell::buildGrids_()
+{
+    abstraction_.build(obstacleGrid_, ONE);
+    buildClearance_();
+    buildComponents_();
+
+    obstacleGrid_.trackChanges(true);
+}
+
+bool WorldCell::upload()
+{
+    CellLoadState state = getLoadState();
+    if (state == CELL_READY)
+        return true;
+    if (state != CELL_READY_TO_UPLOAD)
+        return false;
+
+    if (floor_ != nullptr)
+        floor_->uploadTexture();
+
+    for (auto &entity : entities_)
+    {
+        entity->uploadTexture();
+    }
+
+    loadState_.store(CELL_READY, std::memory_order_release);
+    return true;
+}
+
+void WorldCell::requestLoad(const int &priority)
+{
+    CellLoadState state = getLoadState();
+    if (state == CELL_QUEUED)
+    {
+        jobPool_->setPriority(loadJob_, priority);
+        return;
+    }
+
+    if (state != CELL_UNLOADED)
+        return;
+
+    loadState_.store(CELL_QUEUED, std::memory_order_relaxed);
+    loadJob_ = jobPool_->submit([this]
+                                { load(); },
+                                priority);
+}
+
+void WorldCell::cancelLoad()
+{
+    if (getLoadState() != CELL_QUEUED)
+        return;
+
+    // Cancelled jobs never run, so nothing else touches the state
+    if (jobPool_->cancel(loadJob_))
+        loadState_.store(CELL_UNLOADED, std::memory_order_relaxed);
+}
+
+bool WorldCell::isLoadQueued() const
+{
+    return getLoadState() == CELL_QUEUED;
+}
+
+bool WorldCell::isLoading() const
+{
+    return loadJob_ != nullptr && loadJob_->getStatus() == JOB_RUNNING;
+}
+
+void WorldCell::measureMemory_(const Ground &ground)
+{
+    memory_.texture = ground.getTextureBytes();
+
+    // load() only places trees
+    memory_.entities = sizeof(Ground) +
+                       entities_.size() * (sizeof(TropicalTree) + sizeof(Entity *)) +
+                       broadPhase_.getBytes();
+
+    std::size_t cells = obstacleGrid_.cols() * obstacleGrid_.rows();
+    std::size_t entrances = abstraction_.getEntrances().size();
+    memory_.grids = cells * sizeof(int) +
+                    cells * 2 * sizeof(unsigned char) +
+                    cells * 2 * sizeof(int) +
+                    entrances * sizeof(CellEntrance) +
+                    entrances * entrances * sizeof(float);
 }
 
 void WorldCell::_addObstacle(const Entity &entity)
@@ -111,7 +225,7 @@ void WorldCell::_addObstacle(const Entity &entity)
 
 const int &WorldCell::obstacleGridValue(const int &i, const int &j) const
 {
-    if (!loaded_)
+    if (!isLoaded())
         return ZERO;
 
     if (!obstacleGrid_.validIndex(i, j))
@@ -120,9 +234,55 @@ const int &WorldCell::obstacleGridValue(const int &i, const int &j) const
     return obstacleGrid_.value(i, j);
 }
 
+void WorldCell::setObstacle(const int &i, const int &j, const int &value)
+{
+    if (!isLoaded())
+        return;
+
+    obstacleGrid_.set(i, j, value);
+}
+
+void WorldCell::takeObstacleChanges(std::vector<std::pair<int, int>> &out)
+{
+    if (!isLoaded())
+        return;
+
+    int count = out.size();
+    obstacleGrid_.takeChanges(out);
+
+    // Edits anywhere can change the distances between entrances, not only
+    // the entrances on the border
+    if (out.size() != count)
+    {
+        abstraction_.build(obstacleGrid_, ONE);
+        buildClearance_();
+        buildComponents_();
+    }
+}
+
+void WorldCell::buildClearance_()
+{
+    ClearanceMap::build(obstacleGrid_, 1, clearance_[0]);
+    ClearanceMap::build(obstacleGrid_, 2, clearance_[1]);
+}
+
+void WorldCell::buildComponents_()
+{
+    componentCount_[0] = ComponentLabels::build(obstacleGrid_, 1, components_[0]);
+    componentCount_[1] = ComponentLabels::build(obstacleGrid_, 2, components_[1]);
+}
+
+const CellAbstraction *WorldCell::getAbstraction() const
+{
+    if (!isLoaded())
+        return nullptr;
+
+    return &abstraction_;
+}
+
 Entity *WorldCell::getFloor()
 {
-    if (!loaded_)
+    if (!isReady())
     {
         return &placeholder_;
     }
@@ -135,26 +295,8 @@ Entity *WorldCell::getFloor()
 
 std::vector<Entity *> &WorldCell::getEntities()
 {
-    if (!loaded_)
+    if (!isReady())
         return placeholders_;
 
     return entities_;
 }
-
-void WorldCell::translateOrigin(const Vector3f &newOrigin)
-{
-    if (!loaded_)
-        return;
-
-    if (origin_ == newOrigin)
-        return;
-
-    floor_->translateOrigin(newOrigin);
-
-    for (auto &entity : entities_)
-    {
-        entity->translateOrigin(newOrigin);
-    }
-
-    origin_ = newOrigin;
-}
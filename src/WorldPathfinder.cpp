@@ -1,5 +1,8 @@
 #include "WorldPathfinder.hpp"
 
+const int MAX_FLOW_FIELDS = 16;
+const int DEFAULT_PATH_CACHE_SIZE = 64;
+
 WorldPathfinder::WorldPathfinder(const Vector3f &position,
                                  WorldConfig &worldConfig) : Pathfinder(position,
                                                                         worldConfig.getCellWidth() * 3.f,
@@ -8,29 +11,324 @@ WorldPathfinder::WorldPathfinder(const Vector3f &position,
                                                                         worldConfig.subRows() * 3),
                                                              cellCols_(worldConfig.subCols()),
                                                              cellRows_(worldConfig.subRows()),
+                                                             validCellValue_(1),
                                                              currentCells_{nullptr},
-                                                             validCellValue_(1)
+                                                             loadedCells_{false},
+                                                             start_i_(0),
+                                                             start_j_(0),
+                                                             windowSet_(false),
+                                                             version_(0),
+                                                             cacheSize_(DEFAULT_PATH_CACHE_SIZE),
+                                                             cacheHits_(0),
+                                                             cacheMisses_(0),
+                                                             rowWords_((worldConfig.subCols() * 3 + 63) / 64),
+                                                             componentOffset_{}
 {
+    walkable_[0].assign(rowWords_ * getRows(), 0);
+    walkable_[1].assign(rowWords_ * getRows(), 0);
+    clearance_[0].assign(getCols() * getRows(), 0);
+    clearance_[1].assign(getCols() * getRows(), 0);
 }
 
 void WorldPathfinder::setActiveCells(const int &start_i, const int &start_j,
                                      const std::vector<WorldCell *> &activeCells)
 {
+    gridChanged_();
+
+    WorldCell *cells[3][3] = {};
+    for (auto &cell : activeCells)
+    {
+        cells[cell->geti() - start_i][cell->getj() - start_j] = cell;
+    }
+
+    // Slots still in the window must hold the cells they held before
+    int shift_i = start_i - start_i_;
+    int shift_j = start_j - start_j_;
+    bool shifted = windowSet_ && abs(shift_i) < 2 && abs(shift_j) < 2;
+    for (int i = 0; i < 3 && shifted; i++)
+    {
+        for (int j = 0; j < 3 && shifted; j++)
+        {
+            int old_i = i + shift_i;
+            int old_j = j + shift_j;
+            if (old_i >= 0 && old_i < 3 && old_j >= 0 && old_j < 3)
+                shifted = currentCells_[old_i][old_j] == cells[i][j];
+        }
+    }
+
+    WorldCell *previousCells[3][3];
+    bool previousLoaded[3][3];
+    std::copy(&currentCells_[0][0], &currentCells_[0][0] + 9, &previousCells[0][0]);
+    std::copy(&loadedCells_[0][0], &loadedCells_[0][0] + 9, &previousLoaded[0][0]);
+
+    // Kept cells keep their pending changes for collectChanges, new ones
+    // are read whole
+    std::vector<std::pair<int, int>> staleChanges;
+    bool kept[3][3];
     for (int i = 0; i < 3; i++)
     {
         for (int j = 0; j < 3; j++)
         {
-            currentCells_[i][j] = nullptr;
+            int old_i = i + shift_i;
+            int old_j = j + shift_j;
+            kept[i][j] = shifted && old_i >= 0 && old_i < 3 && old_j >= 0 && old_j < 3;
+
+            currentCells_[i][j] = cells[i][j];
+            if (kept[i][j])
+            {
+                loadedCells_[i][j] = previousLoaded[old_i][old_j];
+                continue;
+            }
+
+            loadedCells_[i][j] = cells[i][j] != nullptr && cells[i][j]->isLoaded();
+            if (cells[i][j] != nullptr)
+                cells[i][j]->takeObstacleChanges(staleChanges);
         }
     }
 
-    int i, j;
-    for (auto &cell : activeCells)
+    start_i_ = start_i;
+    start_j_ = start_j;
+    windowSet_ = true;
+
+    if (!shifted)
+    {
+        rebuildWalkable_();
+        rebuildClearance_();
+        rebuildComponents_();
+        return;
+    }
+
+    shiftGrids_(shift_i, shift_j);
+
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            if (kept[i][j])
+                continue;
+            for (int ci = 0; ci < cellCols_; ci++)
+            {
+                for (int cj = 0; cj < cellRows_; cj++)
+                    updateWalkable_(i * cellCols_ + ci, j * cellRows_ + cj);
+            }
+        }
+    }
+
+    // The new cells, the kept ones close enough to them to be lowered, and
+    // the ones now on the opposite edge of the window
+    int cols = getCols();
+    int rows = getRows();
+    if (shift_i > 0)
     {
-        i = cell->geti() - start_i;
-        j = cell->getj() - start_j;
-        currentCells_[i][j] = cell;
+        refreshClearance_(cols - cellCols_ - MAX_CLEARANCE, 0, cols, rows);
+        refreshClearance_(0, 0, MAX_CLEARANCE, rows);
     }
+    else if (shift_i < 0)
+    {
+        refreshClearance_(0, 0, cellCols_ + MAX_CLEARANCE, rows);
+        refreshClearance_(cols - MAX_CLEARANCE, 0, cols, rows);
+    }
+    if (shift_j > 0)
+    {
+        refreshClearance_(0, rows - cellRows_ - MAX_CLEARANCE, cols, rows);
+        refreshClearance_(0, 0, cols, MAX_CLEARANCE);
+    }
+    else if (shift_j < 0)
+    {
+        refreshClearance_(0, 0, cols, cellRows_ + MAX_CLEARANCE);
+        refreshClearance_(0, rows - MAX_CLEARANCE, cols, rows);
+    }
+
+    // Only joins labels along the cell borders, no grid cells are read
+    rebuildComponents_();
+}
+
+void WorldPathfinder::collectChanges(std::vector<std::pair<int, int>> &out_changes)
+{
+    int count = out_changes.size();
+    std::vector<std::pair<int, int>> cellChanges;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            WorldCell *cell = currentCells_[i][j];
+            if (cell == nullptr || !cell->isLoaded())
+                continue;
+
+            if (!loadedCells_[i][j])
+            {
+                // Everything in the cell went from blocked to its real value
+                loadedCells_[i][j] = true;
+                gridChanged_();
+                cell->takeObstacleChanges(cellChanges);
+                cellChanges.clear();
+                for (int ci = 0; ci < cellCols_; ci++)
+                {
+                    for (int cj = 0; cj < cellRows_; cj++)
+                    {
+                        updateWalkable_(i * cellCols_ + ci, j * cellRows_ + cj);
+                        out_changes.push_back(
+                            std::pair<int, int>(i * cellCols_ + ci, j * cellRows_ + cj));
+                    }
+                }
+                continue;
+            }
+
+            cell->takeObstacleChanges(cellChanges);
+            if (!cellChanges.empty())
+                gridChanged_();
+            for (auto [ci, cj] : cellChanges)
+            {
+                updateWalkable_(i * cellCols_ + ci, j * cellRows_ + cj);
+                out_changes.push_back(
+                    std::pair<int, int>(i * cellCols_ + ci, j * cellRows_ + cj));
+            }
+            cellChanges.clear();
+        }
+    }
+
+    if (out_changes.size() != count)
+    {
+        rebuildClearance_();
+        rebuildComponents_();
+    }
+}
+
+const FlowField &WorldPathfinder::getFlowField(const int &goal_i, const int &goal_j)
+{
+    // Wider agents get their own fields
+    int goal = index(goal_i, goal_j) * (MAX_CLEARANCE + 1) +
+               std::clamp(getAgentClearance(), 0, MAX_CLEARANCE);
+
+    auto search = flowFields_.find(goal);
+    if (search != flowFields_.end())
+        return search->second;
+
+    if (flowFields_.size() >= MAX_FLOW_FIELDS)
+        flowFields_.clear();
+
+    FlowField &field = flowFields_.try_emplace(goal, *this).first->second;
+    field.build(goal_i, goal_j);
+    return field;
+}
+
+void WorldPathfinder::setCacheSize(const int &size)
+{
+    cacheSize_ = std::max(size, 0);
+    while (pathCache_.size() > cacheSize_)
+    {
+        pathCacheIndex_.erase(pathCache_.back().key);
+        pathCache_.pop_back();
+    }
+}
+
+uint64_t WorldPathfinder::getCacheKey(const int &start_i, const int &start_j,
+                                      const int &end_i, const int &end_j,
+                                      const bool &diagonal,
+                                      const PathSearch &search) const
+{
+    // Everything that changes the result besides the grid itself and the
+    // heuristic weight, which is kept with each entry
+    uint64_t key = (uint64_t)index(start_i, start_j);
+    key = (key << 16) | (uint64_t)index(end_i, end_j);
+    key = (key << 8) | (uint64_t)(validCellValue_ & 0xff);
+    key = (key << 8) | (uint64_t)(getAgentClearance() & 0xff);
+    key = (key << 2) | ((uint64_t)diagonal << 1) | (uint64_t)(search == SEARCH_JPS);
+    return key;
+}
+
+bool WorldPathfinder::findCachedPath(const uint64_t &key,
+                                     std::vector<std::pair<int, int>> &resultPath,
+                                     bool &out_found)
+{
+    if (cacheSize_ == 0)
+        return false;
+
+    auto cached = pathCacheIndex_.find(key);
+    if (cached != pathCacheIndex_.end())
+    {
+        auto entry = cached->second;
+        if (entry->version == version_ && entry->heuristicWeight == getHeuristicWeight())
+        {
+            cacheHits_ += 1;
+            pathCache_.splice(pathCache_.begin(), pathCache_, entry);
+            resultPath = entry->path;
+            out_found = entry->found;
+            return true;
+        }
+        pathCache_.erase(entry);
+        pathCacheIndex_.erase(cached);
+    }
+
+    cacheMisses_ += 1;
+    return false;
+}
+
+void WorldPathfinder::cachePath(const uint64_t &key, const float &heuristicWeight,
+                                const unsigned int &version,
+                                const bool &found,
+                                const std::vector<std::pair<int, int>> &path)
+{
+    // Found on a grid that has changed since
+    if (cacheSize_ == 0 || version != version_)
+        return;
+
+    auto cached = pathCacheIndex_.find(key);
+    if (cached != pathCacheIndex_.end())
+        pathCache_.erase(cached->second);
+
+    CachedPath entry;
+    entry.key = key;
+    entry.heuristicWeight = heuristicWeight;
+    entry.version = version;
+    entry.found = found;
+    entry.path = path;
+    pathCache_.push_front(std::move(entry));
+    pathCacheIndex_[key] = pathCache_.begin();
+
+    if (pathCache_.size() > cacheSize_)
+    {
+        pathCacheIndex_.erase(pathCache_.back().key);
+        pathCache_.pop_back();
+    }
+}
+
+bool WorldPathfinder::searchCells_(const int &start_i, const int &start_j,
+                                   const int &end_i, const int &end_j,
+                                   const bool &diagonal,
+                                   const PathSearch &search,
+                                   std::vector<std::pair<int, int>> &resultPath)
+{
+    if (cacheSize_ == 0 || !(validIndex(start_i, start_j) && validIndex(end_i, end_j)))
+        return Pathfinder::searchCells_(start_i, start_j, end_i, end_j, diagonal, search, resultPath);
+
+    uint64_t key = getCacheKey(start_i, start_j, end_i, end_j, diagonal, search);
+
+    bool found;
+    if (findCachedPath(key, resultPath, found))
+    {
+        clearSearchStats_();
+        return found;
+    }
+
+    found = Pathfinder::searchCells_(start_i, start_j, end_i, end_j, diagonal, search, resultPath);
+    cachePath(key, getHeuristicWeight(), version_, found, resultPath);
+
+    return found;
+}
+
+void WorldPathfinder::gridChanged_()
+{
+    version_ += 1;
+    flowFields_.clear();
+}
+
+void WorldPathfinder::setValidCellValue(const int &value)
+{
+    if (value != validCellValue_)
+        flowFields_.clear();
+
+    validCellValue_ = value;
 }
 
 bool WorldPathfinder::validCell(const int &i, const int &j) const
@@ -38,10 +336,362 @@ bool WorldPathfinder::validCell(const int &i, const int &j) const
     if (!validIndex(i, j))
         return false;
 
-    if (value_(i, j) != validCellValue_)
+    int layer = layer_(validCellValue_);
+    if (layer < 0)
+        return value_(i, j) == validCellValue_;
+
+    return (walkable_[layer][j * rowWords_ + i / 64] >> (i % 64)) & 1;
+}
+
+int WorldPathfinder::clearance(const int &i, const int &j) const
+{
+    if (!validIndex(i, j))
+        return 0;
+
+    int layer = layer_(validCellValue_);
+    if (layer < 0)
+        return Pathfinder::clearance(i, j);
+
+    return clearance_[layer][index(i, j)];
+}
+
+bool WorldPathfinder::sameComponent(const int &a_i, const int &a_j,
+                                    const int &b_i, const int &b_j) const
+{
+    int layer = layer_(validCellValue_);
+    if (layer < 0)
+        return true;
+
+    // Searches can still step off a blocked start cell
+    int a = component_(layer, a_i, a_j);
+    int b = component_(layer, b_i, b_j);
+    if (a < 0 || b < 0)
+        return true;
+
+    return a == b;
+}
+
+bool WorldPathfinder::isAreaFree(const Vector3f &localPosition, const Vector3f &size) const
+{
+    if (layer_(validCellValue_) < 0)
+        return Pathfinder::isAreaFree(localPosition, size);
+
+    Vector3f topLeft = localPosition - (size / 2.f);
+
+    int start_i = (int)floor(topLeft.x / getCellWidth());
+    int start_j = (int)floor(topLeft.y / getCellHeight());
+
+    int end_i = (int)ceil((topLeft.x + size.x) / getCellWidth());
+    int end_j = (int)ceil((topLeft.y + size.y) / getCellHeight());
+
+    int center_i, center_j;
+    toLocalGridCoord(localPosition, center_i, center_j);
+
+    // Chessboard radius from the centre cell that covers the whole area
+    int radius = std::max(std::max(center_i - start_i, end_i - 1 - center_i),
+                          std::max(center_j - start_j, end_j - 1 - center_j));
+
+    if (clearance(center_i, center_j) > radius)
+        return true;
+
+    // Near obstacles, or in areas lopsided around the centre cell
+    return Pathfinder::isAreaFree(localPosition, size);
+}
+
+bool WorldPathfinder::rowFree(const int &j, const int &start_i, const int &end_i) const
+{
+    int layer = layer_(validCellValue_);
+    if (layer < 0)
+        return Pathfinder::rowFree(j, start_i, end_i);
+
+    if (start_i >= end_i)
+        return true;
+
+    // Cells outside the grid are never free
+    if (!(validIndex(start_i, j) && validIndex(end_i - 1, j)))
         return false;
 
-    return true;
+    return rowBits_(layer, j, start_i, end_i, true);
+}
+
+bool WorldPathfinder::rowHasFree(const int &j, const int &start_i, const int &end_i) const
+{
+    int layer = layer_(validCellValue_);
+    if (layer < 0)
+        return Pathfinder::rowHasFree(j, start_i, end_i);
+
+    if (j < 0 || j > getRows() - 1)
+        return false;
+
+    return rowBits_(layer, j, std::max(start_i, 0), std::min(end_i, getCols()), false);
+}
+
+bool WorldPathfinder::rowBits_(const int &layer, const int &j, int start_i, int end_i, const bool &all) const
+{
+    const uint64_t *row = &walkable_[layer][j * rowWords_];
+    while (start_i < end_i)
+    {
+        int word = start_i / 64;
+        int first = start_i % 64;
+        int count = std::min(end_i - start_i, 64 - first);
+
+        uint64_t mask = (count == 64) ? ~uint64_t(0) : (((uint64_t(1) << count) - 1) << first);
+        uint64_t bits = row[word] & mask;
+
+        if (all && bits != mask)
+            return false;
+        if (!all && bits != 0)
+            return true;
+
+        start_i += count;
+    }
+    return all;
+}
+
+void WorldPathfinder::rebuildWalkable_()
+{
+    std::fill(walkable_[0].begin(), walkable_[0].end(), 0);
+    std::fill(walkable_[1].begin(), walkable_[1].end(), 0);
+
+    for (int j = 0; j < getRows(); j++)
+    {
+        for (int i = 0; i < getCols(); i++)
+        {
+            int layer = layer_(value_(i, j));
+            if (layer >= 0)
+                walkable_[layer][j * rowWords_ + i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+}
+
+void WorldPathfinder::rebuildClearance_()
+{
+    refreshClearance_(0, 0, getCols(), getRows());
+}
+
+void WorldPathfinder::refreshClearance_(const int &start_i, const int &start_j,
+                                        const int &end_i, const int &end_j)
+{
+    int cols = getCols();
+    int rows = getRows();
+
+    // Blocked cells this close to the area can still lower it
+    int reach_i = std::max(start_i - MAX_CLEARANCE, 0);
+    int reach_j = std::max(start_j - MAX_CLEARANCE, 0);
+    int reachCols = std::min(end_i + MAX_CLEARANCE, cols) - reach_i;
+    int reachRows = std::min(end_j + MAX_CLEARANCE, rows) - reach_j;
+
+    std::vector<unsigned char> lowered;
+    std::vector<int> seeds;
+    for (int layer = 0; layer < 2; layer++)
+    {
+        std::vector<unsigned char> &clearance = clearance_[layer];
+
+        // Each WorldCell's own clearances, clipped by the window's edge
+        for (int j = start_j; j < end_j; j++)
+        {
+            for (int i = start_i; i < end_i; i++)
+            {
+                WorldCell *cell = currentCells_[i / cellCols_][j / cellRows_];
+                int value = 0;
+                if (cell != nullptr && cell->isLoaded() &&
+                    ((walkable_[layer][j * rowWords_ + i / 64] >> (i % 64)) & 1))
+                {
+                    int local = (i % cellCols_) + cellCols_ * (j % cellRows_);
+                    value = cell->getClearance(layer)[local];
+                }
+                value = std::min(value, std::min(i + 1, cols - i));
+                value = std::min(value, std::min(j + 1, rows - j));
+                clearance[index(i, j)] = value;
+            }
+        }
+
+        // Blocked cells near a cell border can lower clearances across it,
+        // further in the WorldCells' own values are already exact
+        seeds.clear();
+        for (int j = reach_j; j < reach_j + reachRows; j++)
+        {
+            int local_j = j % cellRows_;
+            bool nearRowBorder = local_j < MAX_CLEARANCE || local_j > cellRows_ - 1 - MAX_CLEARANCE;
+            for (int i = reach_i; i < reach_i + reachCols; i++)
+            {
+                int local_i = i % cellCols_;
+                bool nearBorder = nearRowBorder || local_i < MAX_CLEARANCE || local_i > cellCols_ - 1 - MAX_CLEARANCE;
+                if (!nearBorder)
+                    continue;
+
+                WorldCell *cell = currentCells_[i / cellCols_][j / cellRows_];
+                if (cell == nullptr || !cell->isLoaded() ||
+                    !((walkable_[layer][j * rowWords_ + i / 64] >> (i % 64)) & 1))
+                    seeds.push_back((i - reach_i) + reachCols * (j - reach_j));
+            }
+        }
+
+        lowered.assign(reachCols * reachRows, MAX_CLEARANCE);
+        ClearanceMap::lowerFrom(seeds, reachCols, reachRows, lowered);
+
+        for (int j = start_j; j < end_j; j++)
+        {
+            for (int i = start_i; i < end_i; i++)
+            {
+                unsigned char &value = clearance[index(i, j)];
+                value = std::min(value, lowered[(i - reach_i) + reachCols * (j - reach_j)]);
+            }
+        }
+    }
+}
+
+void WorldPathfinder::shiftGrids_(const int &shift_i, const int &shift_j)
+{
+    int cols = getCols();
+    int rows = getRows();
+    int offset_i = shift_i * cellCols_;
+    int offset_j = shift_j * cellRows_;
+
+    // Grid cell (i, j) takes what was at (i + offset_i, j + offset_j),
+    // whatever comes from outside the old window is read again after
+    std::vector<uint64_t> previousBits;
+    std::vector<unsigned char> previousClearance;
+    for (int layer = 0; layer < 2; layer++)
+    {
+        previousBits.swap(walkable_[layer]);
+        walkable_[layer].assign(previousBits.size(), 0);
+
+        previousClearance.swap(clearance_[layer]);
+        clearance_[layer].assign(previousClearance.size(), 0);
+
+        for (int j = 0; j < rows; j++)
+        {
+            int old_j = j + offset_j;
+            if (old_j < 0 || old_j > rows - 1)
+                continue;
+
+            const uint64_t *oldRow = &previousBits[old_j * rowWords_];
+            uint64_t *row = &walkable_[layer][j * rowWords_];
+            for (int w = 0; w < rowWords_; w++)
+            {
+                // The 64 old bits starting at this word's first cell
+                int first = w * 64 + offset_i;
+                int word = (first >= 0) ? first / 64 : -1 - (-first - 1) / 64;
+                int bit = first - word * 64;
+
+                uint64_t low = (word >= 0 && word < rowWords_) ? oldRow[word] : 0;
+                uint64_t high = (word + 1 >= 0 && word + 1 < rowWords_) ? oldRow[word + 1] : 0;
+                row[w] = (bit == 0) ? low : (low >> bit) | (high << (64 - bit));
+            }
+
+            // Nothing past the last column
+            if (cols % 64 != 0)
+                row[rowWords_ - 1] &= (uint64_t(1) << (cols % 64)) - 1;
+
+            int start_i = std::max(0, -offset_i);
+            int end_i = std::min(cols, cols - offset_i);
+            std::copy(&previousClearance[index(start_i + offset_i, old_j)],
+                      &previousClearance[index(start_i + offset_i, old_j)] + (end_i - start_i),
+                      &clearance_[layer][index(start_i, j)]);
+        }
+    }
+}
+
+void WorldPathfinder::rebuildComponents_()
+{
+    for (int layer = 0; layer < 2; layer++)
+    {
+        // Every label of every loaded WorldCell starts as its own root
+        int count = 0;
+        for (int ci = 0; ci < 3; ci++)
+        {
+            for (int cj = 0; cj < 3; cj++)
+            {
+                componentOffset_[layer][ci][cj] = count;
+                if (loadedCells_[ci][cj])
+                    count += currentCells_[ci][cj]->getComponentCount(layer) + 1;
+            }
+        }
+
+        std::vector<int> &root = componentRoot_[layer];
+        root.resize(count);
+        for (int n = 0; n < count; n++)
+            root[n] = n;
+
+        auto find = [&root](int n)
+        {
+            while (root[n] != n)
+            {
+                root[n] = root[root[n]];
+                n = root[n];
+            }
+            return n;
+        };
+
+        auto label = [&](const int &ci, const int &cj, const int &local_i, const int &local_j)
+        {
+            int value = currentCells_[ci][cj]->getComponents(layer)[local_i + cellCols_ * local_j];
+            return value == 0 ? -1 : componentOffset_[layer][ci][cj] + value;
+        };
+
+        auto join = [&](const int &a, const int &b)
+        {
+            if (a >= 0 && b >= 0)
+                root[find(a)] = find(b);
+        };
+
+        // Walkable cells facing each other across a border join components
+        for (int ci = 0; ci < 3; ci++)
+        {
+            for (int cj = 0; cj < 3; cj++)
+            {
+                if (!loadedCells_[ci][cj])
+                    continue;
+
+                if (ci < 2 && loadedCells_[ci + 1][cj])
+                {
+                    for (int r = 0; r < cellRows_; r++)
+                        join(label(ci, cj, cellCols_ - 1, r), label(ci + 1, cj, 0, r));
+                }
+                if (cj < 2 && loadedCells_[ci][cj + 1])
+                {
+                    for (int c = 0; c < cellCols_; c++)
+                        join(label(ci, cj, c, cellRows_ - 1), label(ci, cj + 1, c, 0));
+                }
+            }
+        }
+
+        // Flattened so lookups need no find
+        for (int n = 0; n < count; n++)
+            root[n] = find(n);
+    }
+}
+
+int WorldPathfinder::component_(const int &layer, const int &i, const int &j) const
+{
+    if (!validIndex(i, j))
+        return -1;
+
+    int cell_i = i / cellCols_;
+    int cell_j = j / cellRows_;
+    if (!loadedCells_[cell_i][cell_j])
+        return -1;
+
+    int local = (i - cell_i * cellCols_) + cellCols_ * (j - cell_j * cellRows_);
+    int value = currentCells_[cell_i][cell_j]->getComponents(layer)[local];
+    if (value == 0)
+        return -1;
+
+    return componentRoot_[layer][componentOffset_[layer][cell_i][cell_j] + value];
+}
+
+void WorldPathfinder::updateWalkable_(const int &i, const int &j)
+{
+    uint64_t bit = uint64_t(1) << (i % 64);
+    int word = j * rowWords_ + i / 64;
+
+    walkable_[0][word] &= ~bit;
+    walkable_[1][word] &= ~bit;
+
+    int layer = layer_(value_(i, j));
+    if (layer >= 0)
+        walkable_[layer][word] |= bit;
 }
 
 const int &WorldPathfinder::cellValue(const int &i, const int &j) const
@@ -0,0 +1,22 @@
+#ifndef __PATHTESTUTIL_H__
+#define __PATHTESTUTIL_H__
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+// Length of a path of adjacent cells, straight steps cost 1 and diagonal
+// steps sqrt(2)
+inline float pathCost(const std::vector<std::pair<int, int>> &path)
+{
+    float cost = 0;
+    for (int n = 1; n < path.size(); n++)
+    {
+        int di = abs(path[n].first - path[n - 1].first);
+        int dj = abs(path[n].second - path[n - 1].second);
+        cost += (di && dj) ? M_SQRT2 : 1.f;
+    }
+    return cost;
+}
+
+#endif // __PATHTESTUTIL_H__
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+
+#include "AsyncPathfinder.hpp"
+
+bool waitFor(const std::shared_ptr<PathRequest> &request)
+{
+    for (int n = 0; n < 1000; n++)
+    {
+        if (request->isReady())
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+int main()
+{
+    std::cout << "# Testing AsyncPathfinder" << std::endl;
+
+    int g_cols = 20;
+    int g_rows = 20;
+
+    GridPathfinder source(
+        Vector3f(100.f, 100.f, 0.f),
+        200.f, 200.f,
+        g_cols, g_rows);
+    source.clearGrid();
+    for (int j = 0; j < 15; j++)
+        source.setCellValue(10, j, 0);
+
+    AsyncPathfinder async(200.f, 200.f, g_cols, g_rows);
+
+    int owner;
+    auto request = async.request(&owner, source, source.toPoint(2, 2), source.toPoint(18, 2), true, SEARCH_JPS);
+
+    // Changing the source after the request does not affect the search
+    for (int j = 0; j < g_rows; j++)
+        source.setCellValue(10, j, 0);
+
+    if (!waitFor(request) || !request->isFound())
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    std::cout << "Path has " << request->getPath().size() << " waypoints\n";
+
+    if (request->getPath().back() != source.toPoint(18, 2))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // The wall is now closed
+    auto blocked = async.request(&owner, source, source.toPoint(2, 2), source.toPoint(18, 2), true);
+    if (!waitFor(blocked) || blocked->getStatus() != PATH_NOT_FOUND)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // A newer request from the same owner replaces the older one, which is
+    // cancelled unless the worker already got to it
+    source.setCellValue(10, 18, 1);
+    auto older = async.request(&owner, source, source.toPoint(2, 2), source.toPoint(18, 2), true);
+    auto newer = async.request(&owner, source, source.toPoint(2, 2), source.toPoint(18, 19), true);
+
+    if (!waitFor(older) || !waitFor(newer) || !newer->isFound())
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Finished requests are forgotten, so owners that stop asking are not
+    // kept around
+    for (int n = 0; n < 1000 && async.getOwnerCount() != 0; n++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (async.getOwnerCount() != 0)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Owners that go away take their request with them
+    int otherOwner;
+    auto pending = async.request(&otherOwner, source, source.toPoint(2, 2), source.toPoint(18, 19), true);
+    async.cancel(&otherOwner);
+    if (async.getOwnerCount() != 0 || !waitFor(pending))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Going away cancels the search in flight, a walled in goal on a large
+    // grid would otherwise keep the worker busy well after the destructor
+    std::shared_ptr<PathRequest> inFlight;
+    {
+        int large = 1000;
+        GridPathfinder open(Vector3f(0.f, 0.f, 0.f), 10000.f, 10000.f, large, large);
+        open.clearGrid();
+        for (int i = large - 3; i < large; i++)
+        {
+            for (int j = large - 3; j < large; j++)
+                open.setCellValue(i, j, (i == large - 2 && j == large - 2) ? 1 : 0);
+        }
+
+        AsyncPathfinder stopping(10000.f, 10000.f, large, large);
+        inFlight = stopping.request(&owner, open, open.toPoint(0, 0), open.toPoint(large - 2, large - 2), true);
+
+        // Once a partial path comes back the worker is searching it
+        std::deque<Vector3f> partial;
+        for (int n = 0; n < 1000 && !inFlight->takePartialPath(partial); n++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (inFlight->getStatus() != PATH_CANCELLED)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    PathRequest cancelled(source.toPoint(2, 2), source.toPoint(18, 2), true, SEARCH_ASTAR);
+    cancelled.cancel();
+    if (cancelled.getStatus() != PATH_CANCELLED)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
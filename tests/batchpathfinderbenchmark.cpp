@@ -0,0 +1,92 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+
+#include "../include/GridPathfinder.hpp"
+
+int main()
+{
+    std::cout << "# Testing batched path queries" << std::endl;
+
+    // Same size as the WorldPathfinder grid, 3x3 cells of 40x40
+    int g_cols = 120;
+    int g_rows = 120;
+
+    GridPathfinder pf(
+        Vector3f(0.f, 0.f, 0.f),
+        1200.f, 1200.f,
+        g_cols, g_rows);
+    pf.clearGrid();
+    for (int n = 0; n < 2500; n++)
+        pf.setCellValue((n * 37) % g_cols, (n * 53 + n / 11) % g_rows, 0);
+
+    std::vector<PathQuery> queries;
+    for (int n = 0; queries.size() < 400; n++)
+    {
+        PathQuery query;
+        query.start_i = (n * 7) % 20;
+        query.start_j = (n * 13) % g_rows;
+        query.end_i = g_cols - 1 - (n * 11) % 20;
+        query.end_j = (n * 17) % g_rows;
+        if (!(pf.validCell(query.start_i, query.start_j) && pf.validCell(query.end_i, query.end_j)))
+            continue;
+        queries.push_back(query);
+    }
+
+    // One at a time, as World::findPath does for each entity
+    std::vector<PathQueryResult> serial(queries.size());
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < queries.size(); n++)
+    {
+        serial[n].path.clear();
+        serial[n].found = pf.searchAStar(queries[n].start_i, queries[n].start_j,
+                                         queries[n].end_i, queries[n].end_j,
+                                         true, serial[n].path);
+    }
+    float serialTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<PathQueryResult> batch;
+    pf.findPaths(queries, true, batch);
+
+    start = std::chrono::steady_clock::now();
+    pf.findPaths(queries, true, batch);
+    float batchTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "  " << queries.size() << " paths on " << g_cols << "x" << g_rows << "\n";
+    std::cout << "  serial: " << (float)queries.size() / serialTime << " paths/s\n";
+    std::cout << "  batch (" << std::max((int)std::thread::hardware_concurrency(), 1) << " threads): "
+              << (float)queries.size() / batchTime << " paths/s\n";
+
+    if (batch.size() != queries.size())
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (int n = 0; n < queries.size(); n++)
+    {
+        if (batch[n].found != serial[n].found || batch[n].path != serial[n].path)
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    // Smoothed results match the smoothed serial ones
+    pf.setSmoothPath(true);
+    pf.findPaths(queries, true, batch, SEARCH_JPS, 3);
+    for (int n = 0; n < queries.size(); n++)
+    {
+        std::vector<std::pair<int, int>> smoothed;
+        pf.smoothPath(serial[n].path, smoothed);
+        if (batch[n].found != serial[n].found ||
+            (batch[n].found && (batch[n].path.front() != smoothed.front() ||
+                                batch[n].path.back() != smoothed.back())))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <cmath>
+
+#include "CellAbstraction.hpp"
+
+int main()
+{
+    std::cout << "# Testing CellAbstraction" << std::endl;
+
+    ValueGrid<int> grid(10, 10);
+    grid.fill(0, 0, 10, 10, 1);
+
+    // Wall across the cell with a single gap, water in one corner
+    grid.fill(5, 0, 6, 10, 0);
+    grid.set(5, 7, 1);
+    grid.fill(0, 8, 2, 10, 2);
+    std::cout << grid;
+
+    CellAbstraction abstraction;
+    abstraction.build(grid, 1);
+
+    for (auto &entrance : abstraction.getEntrances())
+    {
+        std::cout << entrance.side << " " << entrance.i << "," << entrance.j << "\n";
+    }
+
+    // Top and bottom are split by the wall, the left side by the water
+    if (abstraction.getEntrances().size() != 6)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    int topLeft = abstraction.findEntrance(SIDE_TOP, 2);
+    int topRight = abstraction.findEntrance(SIDE_TOP, 8);
+    int left = abstraction.findEntrance(SIDE_LEFT, 3);
+
+    if (topLeft < 0 || topRight < 0 || left < 0 || topLeft == topRight)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    if (abstraction.findEntrance(SIDE_TOP, 5) != -1 || abstraction.findEntrance(SIDE_LEFT, 9) != -1)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Both halves connect through the gap
+    float d = abstraction.getDistance(topLeft, topRight);
+    std::cout << "Distance " << d << "\n";
+    if (d == std::numeric_limits<float>::infinity() || d < 6.f)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    if (std::abs(abstraction.getDistance(topRight, topLeft) - d) > 0.001f)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Closing the gap disconnects them
+    grid.set(5, 7, 0);
+    abstraction.build(grid, 1);
+    topLeft = abstraction.findEntrance(SIDE_TOP, 2);
+    topRight = abstraction.findEntrance(SIDE_TOP, 8);
+    if (abstraction.getDistance(topLeft, topRight) != std::numeric_limits<float>::infinity())
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
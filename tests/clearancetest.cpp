@@ -0,0 +1,217 @@
+#include <iostream>
+#include <random>
+
+#include "../include/GridPathfinder.hpp"
+#include "../include/ClearanceMap.hpp"
+#include "../include/DStarLite.hpp"
+#include "../include/FlowField.hpp"
+
+int bruteClearance(const std::vector<char> &walkable, const int &cols, const int &rows,
+                   const bool &edgeBlocked, const int &i, const int &j)
+{
+    int best = MAX_CLEARANCE;
+    for (int bj = -1; bj < rows + 1; bj++)
+    {
+        for (int bi = -1; bi < cols + 1; bi++)
+        {
+            bool outside = bi < 0 || bi > cols - 1 || bj < 0 || bj > rows - 1;
+            bool blocked = outside ? edgeBlocked : !walkable[bi + cols * bj];
+            if (blocked)
+                best = std::min(best, std::max(abs(bi - i), abs(bj - j)));
+        }
+    }
+    return best;
+}
+
+int main()
+{
+    std::cout << "# Testing ClearanceMap" << std::endl;
+
+    int cols = 30;
+    int rows = 20;
+    std::mt19937 random(7);
+    std::vector<char> walkable(cols * rows);
+    for (auto &cell : walkable)
+        cell = (random() % 20) != 0;
+
+    std::vector<unsigned char> clearance;
+    for (int edgeBlocked = 0; edgeBlocked < 2; edgeBlocked++)
+    {
+        ClearanceMap::build(walkable, cols, rows, edgeBlocked, clearance);
+        for (int j = 0; j < rows; j++)
+        {
+            for (int i = 0; i < cols; i++)
+            {
+                if (clearance[i + cols * j] != bruteClearance(walkable, cols, rows, edgeBlocked, i, j))
+                {
+                    std::cout << "Failed\n";
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // Two halves built apart, then lowered from the blocked cells near the
+    // seam, match the whole grid
+    int half = cols / 2;
+    std::vector<char> left(half * rows), right(half * rows);
+    for (int j = 0; j < rows; j++)
+    {
+        for (int i = 0; i < half; i++)
+        {
+            left[i + half * j] = walkable[i + cols * j];
+            right[i + half * j] = walkable[i + half + cols * j];
+        }
+    }
+    std::vector<unsigned char> leftClearance, rightClearance, stitched(cols * rows);
+    ClearanceMap::build(left, half, rows, false, leftClearance);
+    ClearanceMap::build(right, half, rows, false, rightClearance);
+
+    std::vector<int> seeds;
+    for (int j = 0; j < rows; j++)
+    {
+        for (int i = 0; i < cols; i++)
+        {
+            int value = (i < half) ? leftClearance[i + half * j] : rightClearance[i - half + half * j];
+            value = std::min(value, std::min(i + 1, cols - i));
+            value = std::min(value, std::min(j + 1, rows - j));
+            stitched[i + cols * j] = value;
+            if (value == 0 && abs(i - half) < MAX_CLEARANCE + 1)
+                seeds.push_back(i + cols * j);
+        }
+    }
+    ClearanceMap::lowerFrom(seeds, cols, rows, stitched);
+
+    ClearanceMap::build(walkable, cols, rows, true, clearance);
+    if (stitched != clearance)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // A wall with a one cell gap, a wider agent has to go around
+    GridPathfinder pf(
+        Vector3f(0.f, 0.f, 0.f),
+        200.f, 200.f,
+        20, 20);
+    pf.clearGrid();
+    for (int j = 0; j < 15; j++)
+    {
+        if (j != 5)
+            pf.setCellValue(10, j, 0);
+    }
+    pf.buildClearance();
+
+    std::vector<std::pair<int, int>> path;
+    if (!pf.searchAStar(5, 5, 15, 5, true, path) || path.size() != 11)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    pf.setAgentClearance(ClearanceMap::needed(25.f, pf.getCellWidth()));
+    path.clear();
+    if (!pf.searchJPS(5, 5, 15, 5, path))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    if (path.size() < 20)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (auto [i, j] : path)
+    {
+        if (pf.clearance(i, j) < pf.getAgentClearance())
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    // The replanner and flow fields go around the gap as well
+    DStarLite planner(pf);
+    path.clear();
+    if (!planner.plan(5, 5, 15, 5, path) || path.size() < 20)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (auto [i, j] : path)
+    {
+        if (pf.clearance(i, j) < pf.getAgentClearance())
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    // Narrowing a gap after a repair also takes away the cells nearby that
+    // were only wide enough with it open, not just the edited cell
+    GridPathfinder gap(
+        Vector3f(0.f, 0.f, 0.f),
+        200.f, 200.f,
+        20, 20);
+    gap.clearGrid();
+    for (int j = 0; j < 15; j++)
+    {
+        if (j < 3 || j > 7)
+            gap.setCellValue(10, j, 0);
+    }
+    gap.buildClearance();
+    gap.setAgentClearance(3);
+
+    DStarLite gapPlanner(gap);
+    path.clear();
+    if (!gapPlanner.plan(5, 5, 15, 5, path) || path.size() != 11)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    gap.setCellValue(10, 3, 0);
+    gap.buildClearance();
+    gapPlanner.updateCells({std::pair<int, int>(10, 3)}, gap.getAgentClearance());
+    path.clear();
+    if (!gapPlanner.plan(5, 5, 15, 5, path) || path.size() < 20)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (auto [i, j] : path)
+    {
+        if (gap.clearance(i, j) < gap.getAgentClearance())
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    FlowField field(pf);
+    field.build(15, 5);
+    int i = 5;
+    int j = 5;
+    int steps = 0;
+    while (field.next(i, j, i, j))
+    {
+        steps += 1;
+        if (pf.clearance(i, j) < pf.getAgentClearance())
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    if (i != 15 || j != 5 || steps < 15)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
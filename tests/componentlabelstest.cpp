@@ -0,0 +1,114 @@
+#include <iostream>
+
+#include "../include/ComponentLabels.hpp"
+#include "../include/GridPathfinder.hpp"
+
+// Answers sameComponent from labels, like WorldPathfinder
+class LabelledPathfinder : public GridPathfinder
+{
+public:
+    LabelledPathfinder(const std::vector<int> &labels,
+                       const int &gridCols, const int &gridRows) : GridPathfinder(Vector3f(0.f, 0.f, 0.f),
+                                                                                  400.f, 400.f,
+                                                                                  gridCols, gridRows),
+                                                                   labels_(labels){};
+
+    virtual bool sameComponent(const int &a_i, const int &a_j,
+                               const int &b_i, const int &b_j) const
+    {
+        return labels_[index(a_i, a_j)] == labels_[index(b_i, b_j)];
+    }
+
+private:
+    std::vector<int> labels_;
+};
+
+int main()
+{
+    std::cout << "# Testing ComponentLabels" << std::endl;
+
+    // An island with a closed lagoon, and two cells touching only at a
+    // corner, which diagonal moves cannot pass between. They also cut off
+    // the water in the grid's corner
+    ValueGrid<int> grid(10, 8);
+    grid.fill(0, 0, 10, 8, 2);
+    grid.fill(1, 1, 7, 7, 1);
+    grid.fill(3, 3, 5, 5, 2);
+    grid.set(8, 0, 1);
+    grid.set(9, 1, 1);
+
+    std::vector<int> labels;
+    int land = ComponentLabels::build(grid, 1, labels);
+    if (land != 3 || labels[grid.index(1, 1)] != labels[grid.index(6, 6)] ||
+        labels[grid.index(8, 0)] == labels[grid.index(9, 1)] || labels[grid.index(0, 0)] != 0)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    int water = ComponentLabels::build(grid, 2, labels);
+    if (water != 3 || labels[grid.index(3, 3)] == labels[grid.index(0, 0)])
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Labels agree with what a diagonal search can reach
+    int g_cols = 40;
+    int g_rows = 40;
+    GridPathfinder pf(Vector3f(0.f, 0.f, 0.f), 400.f, 400.f, g_cols, g_rows);
+
+    std::vector<int> cells(g_cols * g_rows, 1);
+    std::vector<char> walkable(g_cols * g_rows, 1);
+    for (int n = 0; n < 500; n++)
+    {
+        int cell = (n * 7919) % (g_cols * g_rows);
+        cells[cell] = 0;
+        walkable[cell] = 0;
+    }
+    pf.setGrid(cells);
+
+    int count = ComponentLabels::build(walkable, g_cols, g_rows, labels);
+    std::cout << count << " components" << std::endl;
+
+    std::vector<std::pair<int, int>> path;
+    std::vector<PathQuery> queries;
+    int checked = 0;
+    for (int n = 0; n < 200; n++)
+    {
+        int a = (n * 131) % (g_cols * g_rows);
+        int b = (n * 977 + 13) % (g_cols * g_rows);
+        if (a == b || !walkable[a] || !walkable[b])
+            continue;
+        queries.push_back({a % g_cols, a / g_cols, b % g_cols, b / g_cols});
+
+        bool found = pf.searchAStar(a % g_cols, a / g_cols, b % g_cols, b / g_cols, true, path);
+        if (found != (labels[a] == labels[b]))
+        {
+            std::cout << "Labels disagree with search\nFailed\n";
+            return 1;
+        }
+        checked += 1;
+    }
+    std::cout << checked << " pairs checked" << std::endl;
+
+    // Batched queries between components are rejected before searching.
+    // Cell 0 is blocked, so in no component at all
+    queries.push_back({queries[0].start_i, queries[0].start_j, 0, 0});
+    LabelledPathfinder labelled(labels, g_cols, g_rows);
+    labelled.setGrid(cells);
+    std::vector<PathQueryResult> results;
+    labelled.findPaths(queries, true, results, SEARCH_ASTAR, 2);
+    for (int n = 0; n < queries.size(); n++)
+    {
+        const PathQuery &query = queries[n];
+        bool same = labelled.sameComponent(query.start_i, query.start_j, query.end_i, query.end_j);
+        if (results[n].found != same || (!same && results[n].runs != 0))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <iostream>
+#include <cmath>
+
+#include "../include/GridPathfinder.hpp"
+#include "../include/DStarLite.hpp"
+#include "../include/ValueGrid.hpp"
+#include "PathTestUtil.hpp"
+
+int main()
+{
+    std::cout << "# Testing D* Lite" << std::endl;
+
+    int g_cols = 60;
+    int g_rows = 60;
+
+    GridPathfinder pf(
+        Vector3f(0.f, 0.f, 0.f),
+        600.f, 600.f,
+        g_cols, g_rows);
+    pf.clearGrid();
+    for (int n = 0; n < 400; n++)
+        pf.setCellValue((n * 37) % g_cols, (n * 53 + n / 7) % g_rows, 0);
+    pf.setCellValue(2, 2, 1);
+    pf.setCellValue(57, 57, 1);
+
+    DStarLite planner(pf);
+
+    std::vector<std::pair<int, int>> path;
+    std::vector<std::pair<int, int>> reference;
+    std::vector<std::pair<int, int>> closed;
+
+    if (!planner.plan(2, 2, 57, 57, path) || !pf.searchAStar(2, 2, 57, 57, true, reference))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+    std::cout << "Initial plan " << pathCost(path) << " (" << planner.getRuns() << " runs)\n";
+
+    if (std::abs(pathCost(path) - pathCost(reference)) > 0.001f)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Walk a few steps, then block the path ahead, each time replanning
+    for (int step = 0; step < 5; step++)
+    {
+        auto start = path[3];
+        auto blocked = path[std::min((int)path.size() - 1, 8)];
+        if (blocked == path.back())
+            break;
+        closed.push_back(blocked);
+
+        std::vector<std::pair<int, int>> changed;
+        if (step % 2 == 0)
+        {
+            pf.setCellValue(blocked.first, blocked.second, 0);
+            changed.push_back(blocked);
+            planner.updateCells(changed);
+        }
+        else
+        {
+            planner.setBlocked(blocked.first, blocked.second, true);
+            pf.setCellValue(blocked.first, blocked.second, 0);
+        }
+
+        reference.clear();
+        bool found = planner.plan(start.first, start.second, 57, 57, path);
+        int runs = planner.getRuns();
+        bool referenceFound = pf.searchAStar(start.first, start.second, 57, 57, true, reference);
+
+        std::cout << "Replan " << pathCost(path) << " (" << runs << " runs), A* "
+                  << pathCost(reference) << " (" << pf.getRuns() << " runs)\n";
+
+        if (found != referenceFound)
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        if (found && std::abs(pathCost(path) - pathCost(reference)) > 0.001f)
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        for (auto [i, j] : path)
+        {
+            if (!pf.validCell(i, j))
+            {
+                std::cout << "Failed\n";
+                return 1;
+            }
+        }
+    }
+
+    // Opening the cells again must find the shorter paths back
+    planner.clearBlocked();
+    for (auto [i, j] : closed)
+        pf.setCellValue(i, j, 1);
+    planner.updateCells(closed);
+
+    auto start = path[0];
+    reference.clear();
+    if (!planner.plan(start.first, start.second, 57, 57, path) ||
+        !pf.searchAStar(start.first, start.second, 57, 57, true, reference))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+    std::cout << "Reopened " << pathCost(path) << " (" << planner.getRuns() << " runs), A* "
+              << pathCost(reference) << "\n";
+
+    if (std::abs(pathCost(path) - pathCost(reference)) > 0.001f)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Change log the planner is fed from
+    ValueGrid<int> grid(4, 4);
+    grid.fill(0, 0, 4, 4, 1);
+    grid.trackChanges(true);
+    grid.fill(0, 0, 2, 2, 0);
+    grid.fill(0, 0, 2, 2, 0);
+    grid.set(3, 3, 1);
+
+    std::vector<std::pair<int, int>> changes;
+    grid.takeChanges(changes);
+    if (changes.size() != 4)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    changes.clear();
+    grid.takeChanges(changes);
+    if (!changes.empty())
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
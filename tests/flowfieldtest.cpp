@@ -0,0 +1,107 @@
+#include <iostream>
+#include <cmath>
+
+#include "../include/GridPathfinder.hpp"
+#include "../include/FlowField.hpp"
+#include "PathTestUtil.hpp"
+
+int main()
+{
+    std::cout << "# Testing FlowField" << std::endl;
+
+    int g_cols = 60;
+    int g_rows = 60;
+
+    GridPathfinder pf(
+        Vector3f(0.f, 0.f, 0.f),
+        600.f, 600.f,
+        g_cols, g_rows);
+    pf.clearGrid();
+    for (int n = 0; n < 400; n++)
+        pf.setCellValue((n * 37) % g_cols, (n * 53 + n / 7) % g_rows, 0);
+
+    // Walled off pocket
+    for (int n = 0; n < 5; n++)
+    {
+        pf.setCellValue(n, 50, 0);
+        pf.setCellValue(5, 50 + n, 0);
+    }
+    pf.setCellValue(5, 55, 0);
+    pf.setCellValue(0, 55, 0);
+    for (int n = 0; n < 6; n++)
+        pf.setCellValue(n, 55, 0);
+    pf.setCellValue(2, 52, 1);
+
+    pf.setCellValue(30, 30, 1);
+
+    FlowField field(pf);
+    field.build(30, 30);
+    std::cout << "Built field (" << field.getRuns() << " runs)\n";
+
+    if (field.reachable(2, 52))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Every start follows the field down to the goal at the A* cost
+    int checked = 0;
+    for (int n = 0; n < 30; n++)
+    {
+        int i = (n * 17 + 3) % g_cols;
+        int j = (n * 29 + 11) % g_rows;
+        if (!pf.validCell(i, j))
+            continue;
+
+        std::vector<std::pair<int, int>> reference;
+        bool found = pf.searchAStar(i, j, 30, 30, true, reference);
+        if (found != field.reachable(i, j))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+        if (!found)
+            continue;
+
+        std::vector<std::pair<int, int>> path;
+        path.push_back(std::pair<int, int>(i, j));
+        int next_i, next_j;
+        while (field.next(i, j, next_i, next_j) && path.size() < g_cols * g_rows)
+        {
+            i = next_i;
+            j = next_j;
+            path.push_back(std::pair<int, int>(i, j));
+        }
+
+        if (i != 30 || j != 30)
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        if (std::abs(pathCost(path) - pathCost(reference)) > 0.001f ||
+            std::abs(field.cost(path.front().first, path.front().second) - pathCost(reference)) > 0.001f)
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+        checked++;
+    }
+    std::cout << "Checked " << checked << " paths\n";
+
+    // Directions are unit vectors pointing to the next cell, zero at the goal
+    Vector3f direction = field.direction(pf.toPoint(32, 30));
+    if (std::abs(vecMagnitude2(direction) - 1.f) > 0.001f)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    if (vecMagnitude2(field.direction(pf.toPoint(30, 30))) != 0.f)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+
+#include "../include/GridPathfinder.hpp"
+
+int main()
+{
+    std::cout << "# Testing free cell queries" << std::endl;
+
+    GridPathfinder pf(
+        Vector3f(0.f, 0.f, 0.f),
+        200.f, 200.f,
+        20, 20);
+    pf.clearGrid();
+
+    // Block everything but one cell
+    for (int i = 0; i < 20; i++)
+    {
+        for (int j = 0; j < 20; j++)
+        {
+            pf.setCellValue(i, j, 0);
+        }
+    }
+    pf.setCellValue(13, 8, 1);
+
+    if (!pf.rowHasFree(8, 0, 20) || pf.rowHasFree(8, 0, 13) || pf.rowHasFree(7, 0, 20))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    int i, j;
+    if (!pf.findFreeCell(pf.toPoint(10, 10), 9, i, j) || i != 13 || j != 8)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    if (pf.findFreeCell(pf.toPoint(2, 2), 5, i, j))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Open a 3x3 block, areas inside it are free and areas poking out are not
+    for (int i = 4; i < 7; i++)
+    {
+        for (int j = 4; j < 7; j++)
+        {
+            pf.setCellValue(i, j, 1);
+        }
+    }
+
+    if (!pf.rowFree(5, 4, 7) || pf.rowFree(5, 3, 7))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    if (!pf.isAreaFree(pf.toLocalPoint(5, 5), Vector3f(25.f, 25.f, 0.f)))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    if (pf.isAreaFree(pf.toLocalPoint(5, 5), Vector3f(35.f, 35.f, 0.f)))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <unordered_map>
+
+#include "../include/Camera.hpp"
+#include "../include/WorldConfig.hpp"
+#include "../include/WorldCell.hpp"
+#include "../include/HierarchicalPathfinder.hpp"
+#include "../include/ResourceManager.hpp"
+#include "../include/JobPool.hpp"
+
+int main()
+{
+    std::cout << "# Testing HierarchicalPathfinder" << std::endl;
+
+    Camera camera(Vector3f(0, 0, 0), Vector3f(0, 0, 0), Vector2f(64, 32), 10, 800, 600);
+    WorldConfig worldConfig(4000000.f, 4000000.f, 10000, 10000, 40, 40, camera);
+    ResourceManager rm("");
+    JobPool jobPool(1);
+
+    // Two cells side by side whose border runs overlap without either
+    // covering the middle of the other, rows 0-20 and 15-30
+    ValueGrid<int> left(40, 40);
+    left.fill(0, 0, 40, 40, 1);
+    left.fill(39, 21, 40, 40, 0);
+
+    ValueGrid<int> right(40, 40);
+    right.fill(0, 0, 40, 40, 1);
+    right.fill(0, 0, 1, 15, 0);
+    right.fill(0, 31, 1, 40, 0);
+
+    WorldCell leftCell(rm, worldConfig, jobPool, 0, 0);
+    WorldCell rightCell(rm, worldConfig, jobPool, 1, 0);
+    leftCell.loadObstacles(left);
+    rightCell.loadObstacles(right);
+
+    std::unordered_map<int, WorldCell *> cells;
+    cells[worldConfig.getId(0, 0)] = &leftCell;
+    cells[worldConfig.getId(1, 0)] = &rightCell;
+
+    HierarchicalPathfinder pf(worldConfig, cells);
+
+    std::vector<std::pair<int, int>> path;
+    if (!pf.searchAbstract(5, 5, 70, 35, path))
+    {
+        std::cout << "Overlapping runs not joined\nFailed\n";
+        return 1;
+    }
+
+    if (!pf.searchAbstract(70, 35, 5, 5, path))
+    {
+        std::cout << "Overlapping runs not joined\nFailed\n";
+        return 1;
+    }
+
+    // Edits are picked up with the cell's changes, blocking the overlap
+    // closes the way and opening it again finds it
+    std::vector<std::pair<int, int>> changes;
+    for (int r = 15; r < 21; r++)
+        leftCell.setObstacle(39, r, 0);
+    leftCell.takeObstacleChanges(changes);
+
+    if (pf.findPath(pf.toPoint(5, 5), pf.toPoint(70, 35), path))
+    {
+        std::cout << "Blocked overlap still crossed\nFailed\n";
+        return 1;
+    }
+
+    for (int r = 15; r < 21; r++)
+        leftCell.setObstacle(39, r, 1);
+    leftCell.takeObstacleChanges(changes);
+    if (!pf.findPath(pf.toPoint(5, 5), pf.toPoint(70, 35), path))
+    {
+        std::cout << "Reopened overlap not crossed\nFailed\n";
+        return 1;
+    }
+
+    // No overlap at all, no way across
+    right.fill(0, 0, 1, 40, 0);
+    right.fill(0, 25, 1, 31, 1);
+    rightCell.loadObstacles(right);
+    if (pf.searchAbstract(5, 5, 70, 35, path))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <chrono>
+
+#include "../include/JobPool.hpp"
+
+int main()
+{
+    std::cout << "# Testing JobPool" << std::endl;
+
+    JobPool pool(1);
+
+    // Hold the only worker so the rest queue up behind it
+    std::mutex gate;
+    gate.lock();
+    auto blocker = pool.submit([&gate]
+                               { std::lock_guard<std::mutex> lock(gate); },
+                               0);
+    while (blocker->getStatus() != JOB_RUNNING)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::vector<int> order;
+    std::mutex orderMutex;
+    std::vector<std::shared_ptr<Job>> jobs;
+    int priorities[5] = {2, 1, 0, 1, 2};
+    for (int n = 0; n < 5; n++)
+    {
+        jobs.push_back(pool.submit([n, &order, &orderMutex]
+                                   {
+                                       std::lock_guard<std::mutex> lock(orderMutex);
+                                       order.push_back(n); },
+                                   priorities[n]));
+    }
+
+    // Moved ahead of everything, and one dropped before it runs
+    pool.setPriority(jobs[4], -1);
+    if (!pool.cancel(jobs[3]) || pool.getQueuedCount() != 4)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    gate.unlock();
+    for (auto &job : jobs)
+        pool.wait(job);
+
+    int expected[4] = {4, 2, 1, 0};
+    if (order.size() != 4)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+    for (int n = 0; n < 4; n++)
+    {
+        if (order[n] != expected[n])
+        {
+            std::cout << "Out of order\nFailed\n";
+            return 1;
+        }
+    }
+
+    // Finished jobs can no longer be cancelled
+    if (pool.cancel(jobs[0]) || jobs[3]->getStatus() != JOB_CANCELLED)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // A full pool runs everything
+    JobPool widePool;
+    std::atomic<int> count(0);
+    std::vector<std::shared_ptr<Job>> many;
+    for (int n = 0; n < 100; n++)
+        many.push_back(widePool.submit([&count]
+                                       { count += 1; },
+                                       n % 3));
+    for (auto &job : many)
+        widePool.wait(job);
+
+    std::cout << widePool.getThreadCount() << " threads ran " << count << " jobs" << std::endl;
+    if (count != 100)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <iostream>
+#include <cmath>
+
+#include "../include/GridPathfinder.hpp"
+#include "PathTestUtil.hpp"
+
+bool validPath(const GridPathfinder &pf, const std::vector<std::pair<int, int>> &path)
+{
+    for (int n = 1; n < path.size(); n++)
+    {
+        int di = path[n].first - path[n - 1].first;
+        int dj = path[n].second - path[n - 1].second;
+        if (abs(di) > 1 || abs(dj) > 1)
+            return false;
+        if (!pf.validCell(path[n].first, path[n].second))
+            return false;
+        if (di && dj)
+        {
+            if (!pf.validCell(path[n - 1].first + di, path[n - 1].second))
+                return false;
+            if (!pf.validCell(path[n - 1].first, path[n - 1].second + dj))
+                return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    std::cout << "# Testing Jump Point Search" << std::endl;
+
+    int g_cols = 40;
+    int g_rows = 40;
+
+    GridPathfinder pf(
+        Vector3f(0.f, 0.f, 0.f),
+        400.f, 400.f,
+        g_cols, g_rows);
+
+    // Open beach with a few walls and scattered trees
+    std::vector<int> grid;
+    grid.resize(g_cols * g_rows);
+    std::fill(grid.begin(), grid.end(), 1);
+    for (int j = 0; j < 30; j++)
+        grid[pf.index(10, j)] = 0;
+    for (int j = 10; j < g_rows; j++)
+        grid[pf.index(25, j)] = 0;
+    for (int i = 12; i < 22; i++)
+        grid[pf.index(i, 20)] = 0;
+    for (int n = 0; n < 60; n++)
+        grid[pf.index((n * 7) % g_cols, (n * 13) % g_rows)] = 0;
+    grid[pf.index(1, 1)] = 1;
+    grid[pf.index(38, 2)] = 1;
+    grid[pf.index(38, 38)] = 1;
+    pf.setGrid(grid);
+
+    int ends[3][4] = {
+        {1, 1, 38, 38},
+        {1, 1, 38, 2},
+        {38, 38, 1, 1}};
+
+    for (auto &end : ends)
+    {
+        std::vector<std::pair<int, int>> astarPath;
+        std::vector<std::pair<int, int>> jpsPath;
+
+        bool astarFound = pf.searchAStar(end[0], end[1], end[2], end[3], true, astarPath);
+        int astarRuns = pf.getRuns();
+        bool jpsFound = pf.searchJPS(end[0], end[1], end[2], end[3], jpsPath);
+        int jpsRuns = pf.getRuns();
+
+        std::cout << end[0] << ":" << end[1] << "->" << end[2] << ":" << end[3]
+                  << " A* " << pathCost(astarPath) << " (" << astarRuns << " runs)"
+                  << " JPS " << pathCost(jpsPath) << " (" << jpsRuns << " runs)\n";
+
+        if (astarFound != jpsFound)
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        if (!jpsFound)
+            continue;
+
+        if (jpsPath.front() != std::pair<int, int>(end[0], end[1]) ||
+            jpsPath.back() != std::pair<int, int>(end[2], end[3]))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        if (!validPath(pf, jpsPath))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        if (std::abs(pathCost(jpsPath) - pathCost(astarPath)) > 0.001f)
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        // Weighted A* stays within its bound
+        std::vector<std::pair<int, int>> weightedPath;
+        pf.setHeuristicWeight(1.5f);
+        pf.searchAStar(end[0], end[1], end[2], end[3], true, weightedPath);
+        pf.setHeuristicWeight(1.f);
+
+        std::cout << "  weighted A* " << pathCost(weightedPath) << " (" << pf.getRuns() << " runs)\n";
+
+        if (!validPath(pf, weightedPath) ||
+            pathCost(weightedPath) > pathCost(astarPath) * 1.5f + 0.001f)
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    // No path through a closed wall
+    for (int j = 0; j < g_rows; j++)
+        grid[pf.index(30, j)] = 0;
+    pf.setGrid(grid);
+
+    std::vector<std::pair<int, int>> result;
+    if (pf.searchJPS(1, 1, 38, 38, result))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <iostream>
+
+#include "../include/Camera.hpp"
+#include "../include/WorldConfig.hpp"
+#include "../include/WorldPathfinder.hpp"
+#include "../include/JobPool.hpp"
+#include "../include/ResourceManager.hpp"
+
+int main()
+{
+    std::cout << "# Testing WorldPathfinder path cache" << std::endl;
+
+    Camera camera(Vector3f(0, 0, 0), Vector3f(0, 0, 0), Vector2f(64, 32), 10, 800, 600);
+    WorldConfig worldConfig(4000000.f, 4000000.f, 10000, 10000, 40, 40, camera);
+    WorldPathfinder pf(Vector3f(0, 0, 0), worldConfig);
+
+    // No cells loaded, every search fails, but failures are cached too
+    std::deque<Vector3f> path;
+    Vector3f start = pf.toPoint(10, 10);
+    Vector3f end = pf.toPoint(50, 60);
+
+    pf.findPath(start, end, true, path);
+    pf.findPath(start, end, true, path);
+    if (pf.getCacheMisses() != 1 || pf.getCacheHits() != 1)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Part of the key
+    pf.findPath(start, end, false, path);
+    pf.setValidCellValue(2);
+    pf.findPath(start, end, true, path);
+    pf.setValidCellValue(1);
+    if (pf.getCacheMisses() != 3 || pf.getCacheHits() != 1)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Paths found under another heuristic weight are not reused
+    pf.setHeuristicWeight(2.f);
+    pf.findPath(start, end, true, path);
+    pf.setHeuristicWeight(1.f);
+    pf.findPath(start, end, true, path);
+    if (pf.getCacheMisses() != 5 || pf.getCacheHits() != 1)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // A new window invalidates everything
+    unsigned int version = pf.getVersion();
+    pf.setActiveCells(0, 0, std::vector<WorldCell *>());
+    if (pf.getVersion() == version)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    pf.findPath(start, end, true, path);
+    pf.findPath(start, end, true, path);
+    if (pf.getCacheMisses() != 6 || pf.getCacheHits() != 2)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Least recently used entries go first
+    pf.setCacheSize(2);
+    pf.findPath(start, pf.toPoint(1, 1), true, path);
+    pf.findPath(start, end, true, path);
+    pf.findPath(start, pf.toPoint(2, 2), true, path);
+    pf.findPath(start, end, true, path);
+    pf.findPath(start, pf.toPoint(1, 1), true, path);
+    if (pf.getCacheMisses() != 9 || pf.getCacheHits() != 4)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Loaded cells, all land but for a wall through the middle one
+    ResourceManager rm("");
+    JobPool jobPool(1);
+    ValueGrid<int> land(worldConfig.subCols(), worldConfig.subRows());
+    land.fill(0, 0, land.cols(), land.rows(), 1);
+    ValueGrid<int> walled = land;
+    walled.fill(20, 0, 21, 35, 0);
+
+    std::vector<WorldCell *> cells;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            WorldCell *cell = new WorldCell(rm, worldConfig, jobPool, i, j);
+            cell->loadObstacles((i == 1 && j == 1) ? walled : land);
+            cells.push_back(cell);
+        }
+    }
+    pf.setCacheSize(64);
+    pf.setActiveCells(0, 0, cells);
+
+    // A hit gives the same path as searching again
+    start = pf.toPoint(45, 50);
+    end = pf.toPoint(75, 50);
+    std::deque<Vector3f> missPath, hitPath, freshPath;
+    int misses = pf.getCacheMisses();
+    int hits = pf.getCacheHits();
+    bool found = pf.findPath(start, end, true, missPath);
+    if (pf.getRuns() == 0 || pf.getNodesUsed() == 0)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // The hit reports no search rather than the miss's
+    pf.findPath(start, end, true, hitPath);
+    if (pf.getRuns() != 0 || pf.getNodesUsed() != 0)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+    // Without the cache to compare against
+    pf.setCacheSize(0);
+    pf.findPath(start, end, true, freshPath);
+    pf.setCacheSize(64);
+    if (!found || pf.getCacheMisses() != misses + 1 || pf.getCacheHits() != hits + 1 ||
+        hitPath != missPath || hitPath != freshPath)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Blocking a cell on the path through the obstacle grid invalidates it
+    int blocked_i, blocked_j;
+    pf.toGridCoord(hitPath[hitPath.size() / 2], blocked_i, blocked_j);
+    cells[(blocked_i / 40) * 3 + blocked_j / 40]->setObstacle(blocked_i % 40, blocked_j % 40, 0);
+    std::vector<std::pair<int, int>> changes;
+    pf.collectChanges(changes);
+
+    misses = pf.getCacheMisses();
+    pf.findPath(start, end, true, hitPath);
+    pf.setCacheSize(0);
+    pf.findPath(start, end, true, freshPath);
+    if (pf.getCacheMisses() != misses + 1 || hitPath != freshPath || hitPath == missPath)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (auto &cell : cells)
+    {
+        delete cell;
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "../include/GridPathfinder.hpp"
+
+int main()
+{
+    std::cout << "# Testing Resumable Search" << std::endl;
+
+    int g_cols = 60;
+    int g_rows = 60;
+
+    GridPathfinder pf(
+        Vector3f(0.f, 0.f, 0.f),
+        600.f, 600.f,
+        g_cols, g_rows);
+
+    // Walls that force long detours
+    std::vector<int> grid;
+    grid.resize(g_cols * g_rows);
+    std::fill(grid.begin(), grid.end(), 1);
+    for (int j = 0; j < 50; j++)
+        grid[pf.index(20, j)] = 0;
+    for (int j = 10; j < g_rows; j++)
+        grid[pf.index(40, j)] = 0;
+    pf.setGrid(grid);
+
+    PathSearch searches[2] = {SEARCH_ASTAR, SEARCH_JPS};
+    for (auto search : searches)
+    {
+        std::vector<std::pair<int, int>> fullPath;
+        bool fullFound = search == SEARCH_JPS
+                             ? pf.searchJPS(2, 2, 57, 2, fullPath)
+                             : pf.searchAStar(2, 2, 57, 2, true, fullPath);
+        if (!fullFound)
+        {
+            std::cout << "Full search failed\n";
+            return 1;
+        }
+
+        if (!pf.beginSearch(2, 2, 57, 2, true, search))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        int slices = 0;
+        int partials = 0;
+        float lastDistance = INFINITY;
+        std::vector<std::pair<int, int>> path;
+        // Jump point search expands far fewer nodes, give it smaller slices
+        int budget = search == SEARCH_JPS ? 2 : 20;
+        while (pf.continueSearch(budget) == SEARCH_IN_PROGRESS)
+        {
+            slices += 1;
+
+            // Partial paths start at the start and only get closer to the goal
+            pf.getSearchPath(path);
+            if (path.empty())
+                continue;
+            partials += 1;
+            if (path.front() != std::pair<int, int>(2, 2))
+            {
+                std::cout << "Partial path does not begin at start\nFailed\n";
+                return 1;
+            }
+            // Octile, the heuristic the closest node is picked by
+            int di = std::abs(57 - path.back().first);
+            int dj = std::abs(2 - path.back().second);
+            float distance = std::max(di, dj) + (M_SQRT2 - 1.f) * std::min(di, dj);
+            if (distance > lastDistance)
+            {
+                std::cout << "Partial path moved away from goal\nFailed\n";
+                return 1;
+            }
+            lastDistance = distance;
+        }
+
+        std::cout << "Search " << search << " took " << slices + 1 << " slices, "
+                  << pf.getSearchRuns() << " runs" << std::endl;
+
+        if (slices == 0 || pf.getSearchStatus() != SEARCH_FOUND)
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        // Something to walk along before the search finishes
+        if (partials == 0)
+        {
+            std::cout << "No partial paths\n";
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        pf.getSearchPath(path);
+        if (path != fullPath)
+        {
+            std::cout << "Resumed path differs from full search\nFailed\n";
+            return 1;
+        }
+    }
+
+    // Unreachable goals end as not found
+    grid[pf.index(50, 50)] = 0;
+    for (int i = 49; i < 52; i++)
+    {
+        grid[pf.index(i, 49)] = 0;
+        grid[pf.index(i, 51)] = 0;
+    }
+    grid[pf.index(49, 50)] = 0;
+    grid[pf.index(51, 50)] = 0;
+    grid[pf.index(50, 50)] = 1;
+    pf.setGrid(grid);
+
+    pf.beginSearch(2, 2, 50, 50, true);
+    while (pf.continueSearch(100) == SEARCH_IN_PROGRESS)
+        ;
+    if (pf.getSearchStatus() != SEARCH_NOT_FOUND)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <cmath>
+
+#include "../include/GridPathfinder.hpp"
+#include "PathTestUtil.hpp"
+
+const int COLS = 30;
+const int ROWS = 30;
+
+// Walled in, searches towards it close every reachable cell
+const int CLOSED_I = COLS - 4;
+const int CLOSED_J = ROWS - 4;
+
+void buildGrid(GridPathfinder &pf)
+{
+    pf.clearGrid();
+    for (int n = 0; n < 180; n++)
+        pf.setCellValue((n * 37) % COLS, (n * 53 + n / 7) % ROWS, 0);
+
+    for (int i = CLOSED_I - 1; i < CLOSED_I + 2; i++)
+    {
+        for (int j = CLOSED_J - 1; j < CLOSED_J + 2; j++)
+            pf.setCellValue(i, j, (i == CLOSED_I && j == CLOSED_J) ? 1 : 0);
+    }
+}
+
+// Plain Dijkstra with the same moves as searchAStar, no corner cutting
+float shortestCost(const GridPathfinder &pf,
+                   const int &start_i, const int &start_j,
+                   const int &end_i, const int &end_j,
+                   const bool &diagonal)
+{
+    std::vector<float> cost(COLS * ROWS, INFINITY);
+    std::priority_queue<std::pair<float, int>,
+                        std::vector<std::pair<float, int>>,
+                        std::greater<std::pair<float, int>>>
+        open;
+    cost[pf.index(start_i, start_j)] = 0;
+    open.push({0.f, pf.index(start_i, start_j)});
+    while (!open.empty())
+    {
+        auto [c, cell] = open.top();
+        open.pop();
+        if (c > cost[cell])
+            continue;
+
+        int i = cell % COLS;
+        int j = cell / COLS;
+        for (int ci = -1; ci < 2; ci++)
+        {
+            for (int cj = -1; cj < 2; cj++)
+            {
+                if ((ci == 0 && cj == 0) || !pf.validCell(i + ci, j + cj))
+                    continue;
+                if (ci != 0 && cj != 0 &&
+                    !(diagonal && pf.validCell(i + ci, j) && pf.validCell(i, j + cj)))
+                    continue;
+
+                int next = pf.index(i + ci, j + cj);
+                float nextCost = c + ((ci != 0 && cj != 0) ? M_SQRT2 : 1.f);
+                if (nextCost < cost[next])
+                {
+                    cost[next] = nextCost;
+                    open.push({nextCost, next});
+                }
+            }
+        }
+    }
+    return cost[pf.index(end_i, end_j)];
+}
+
+int main()
+{
+    std::cout << "# Testing search scratch reuse" << std::endl;
+
+    // One pathfinder answers every query, back to back on the same scratch
+    GridPathfinder reused(Vector3f(0.f, 0.f, 0.f), 300.f, 300.f, COLS, ROWS);
+    buildGrid(reused);
+
+    std::vector<PathQuery> queries;
+    for (int n = 0; queries.size() < 60; n++)
+    {
+        PathQuery query;
+        query.start_i = (n * 7) % COLS;
+        query.start_j = (n * 13) % ROWS;
+        query.end_i = (n * 11 + 5) % COLS;
+        query.end_j = (n * 17 + 3) % ROWS;
+        if (!(reused.validCell(query.start_i, query.start_j) && reused.validCell(query.end_i, query.end_j)))
+            continue;
+        queries.push_back(query);
+    }
+
+    int reusedNodes = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (auto &query : queries)
+        {
+            for (int diagonal = 0; diagonal < 2; diagonal++)
+            {
+                std::vector<std::pair<int, int>> path;
+
+                // On the second pass every search follows one that left
+                // most cells stamped open or closed, the next generation
+                // must not see any of them
+                if (pass == 1 && reused.searchAStar(query.start_i, query.start_j,
+                                                    CLOSED_I, CLOSED_J, diagonal, path))
+                {
+                    std::cout << "Found a walled in cell\nFailed\n";
+                    return 1;
+                }
+
+                bool found = reused.searchAStar(query.start_i, query.start_j,
+                                                query.end_i, query.end_j,
+                                                diagonal, path);
+
+                // A pathfinder that never searched before
+                GridPathfinder fresh(Vector3f(0.f, 0.f, 0.f), 300.f, 300.f, COLS, ROWS);
+                buildGrid(fresh);
+                std::vector<std::pair<int, int>> freshPath;
+                bool freshFound = fresh.searchAStar(query.start_i, query.start_j,
+                                                    query.end_i, query.end_j,
+                                                    diagonal, freshPath);
+
+                if (found != freshFound || path != freshPath || reused.getRuns() != fresh.getRuns())
+                {
+                    std::cout << "Differs from a fresh search\nFailed\n";
+                    return 1;
+                }
+
+                // Open nodes lowered in place by decrease-key still leave
+                // the search optimal
+                reusedNodes += reused.getNodesReused();
+                float shortest = shortestCost(reused, query.start_i, query.start_j,
+                                              query.end_i, query.end_j, diagonal);
+                if (found != std::isfinite(shortest) ||
+                    (found && std::abs(pathCost(path) - shortest) > 1e-3f))
+                {
+                    std::cout << "Path is not the shortest\nFailed\n";
+                    return 1;
+                }
+
+                // Nodes come from the pool, at most one per cell, and reuse
+                // does not leave any behind
+                if (reused.getNodesUsed() != fresh.getNodesUsed() ||
+                    reused.getNodesUsed() > COLS * ROWS)
+                {
+                    std::cout << "Node pool grew\nFailed\n";
+                    return 1;
+                }
+            }
+        }
+    }
+
+    std::cout << queries.size() << " queries matched, "
+              << reusedNodes << " open nodes lowered" << std::endl;
+
+    if (reusedNodes == 0)
+    {
+        std::cout << "Decrease-key never ran\nFailed\n";
+        return 1;
+    }
+
+    return 0;
+}
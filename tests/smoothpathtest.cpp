@@ -0,0 +1,90 @@
+#include <iostream>
+
+#include "../include/GridPathfinder.hpp"
+
+int main()
+{
+    std::cout << "# Testing Path Smoothing" << std::endl;
+
+    int g_cols = 20;
+    int g_rows = 20;
+
+    GridPathfinder pf(
+        Vector3f(0.f, 0.f, 0.f),
+        200.f, 200.f,
+        g_cols, g_rows);
+    pf.clearGrid();
+
+    // Wall with a gap at the bottom
+    for (int j = 0; j < 16; j++)
+        pf.setCellValue(10, j, 0);
+
+    if (pf.lineOfSight(2, 2, 18, 2))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    if (!pf.lineOfSight(2, 17, 18, 17) || !pf.lineOfSight(2, 2, 9, 15))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Passing exactly through a corner needs both cells beside it
+    pf.setCellValue(5, 18, 0);
+    if (pf.lineOfSight(4, 18, 5, 19) || pf.lineOfSight(5, 19, 4, 18))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+    pf.setCellValue(5, 18, 1);
+
+    std::vector<std::pair<int, int>> cells;
+    if (!pf.searchAStar(2, 2, 18, 2, true, cells))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    std::vector<std::pair<int, int>> smoothed;
+    pf.smoothPath(cells, smoothed);
+
+    pf.printGrid(2, 2, 18, 2, smoothed);
+    std::cout << cells.size() << " cells smoothed to " << smoothed.size() << " waypoints\n";
+
+    if (smoothed.front() != cells.front() || smoothed.back() != cells.back())
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    if (smoothed.size() >= cells.size() || smoothed.size() < 3)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (int n = 1; n < smoothed.size(); n++)
+    {
+        if (!pf.lineOfSight(smoothed[n - 1].first, smoothed[n - 1].second,
+                            smoothed[n].first, smoothed[n].second))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    // findPath uses the smoothed waypoints when enabled
+    std::deque<Vector3f> path;
+    pf.setSmoothPath(true);
+    pf.findPath(pf.toPoint(2, 2), pf.toPoint(18, 2), true, path);
+    std::cout << "\n";
+    if (path.size() != smoothed.size() - 1 || path.back() != pf.toPoint(18, 2))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    return 0;
+}
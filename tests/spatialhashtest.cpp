@@ -0,0 +1,91 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "../include/SpatialHash.hpp"
+
+bool sameEntities(std::vector<Entity *> a, std::vector<Entity *> b)
+{
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+int main()
+{
+    std::cout << "# Testing SpatialHash" << std::endl;
+
+    SpatialHash hash(40.f);
+
+    // A row of entities 25 apart, both sides of the zero bucket boundary
+    std::vector<Entity *> entities;
+    for (int n = 0; n < 8; n++)
+    {
+        Entity *entity = new Entity();
+        entity->setSize(10, 10, 10);
+        entity->setLocalPosition(Vector3f(-100.f + n * 25.f, 5.f, 0));
+        entities.push_back(entity);
+        hash.insert(entity);
+    }
+
+    // Reference answer from a linear scan
+    auto scanRect = [&entities](const Vector3f &point, const Vector3f &size)
+    {
+        std::vector<Entity *> result;
+        for (auto &entity : entities)
+        {
+            if (entity->collision(point, size))
+                result.push_back(entity);
+        }
+        return result;
+    };
+
+    std::vector<Entity *> found;
+    for (int n = 0; n < 40; n++)
+    {
+        Vector3f point(-120.f + n * 6.f, 2.f, 0);
+        found.clear();
+        hash.queryRect(point, Vector3f(8, 8, 8), found);
+        if (!sameEntities(found, scanRect(point, Vector3f(8, 8, 8))))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    // Radius queries reach the size radius of each entity
+    found.clear();
+    hash.queryRadius(Vector3f(0, 5, 0), 10.f, found);
+    if (!sameEntities(found, {entities[4]}))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Moved across buckets, then removed
+    entities[0]->setLocalPosition(Vector3f(300, 300, 0));
+    hash.update(entities[0]);
+    found.clear();
+    hash.queryRect(Vector3f(300, 300, 0), Vector3f(1, 1, 1), found);
+    if (!sameEntities(found, {entities[0]}))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    hash.remove(entities[0]);
+    found.clear();
+    hash.queryRect(Vector3f(300, 300, 0), Vector3f(1, 1, 1), found);
+    if (!found.empty() || hash.getCount() != 7)
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (auto &entity : entities)
+    {
+        delete entity;
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "../include/StaticBroadPhase.hpp"
+#include "../include/RandomGenerator.hpp"
+
+bool sameEntities(std::vector<Entity *> a, std::vector<Entity *> b)
+{
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+int main()
+{
+    std::cout << "# Testing StaticBroadPhase" << std::endl;
+
+    RandomGenerator r(7);
+
+    // Scattered like the trees of a cell, some overlapping
+    std::vector<Entity *> entities;
+    for (int n = 0; n < 200; n++)
+    {
+        Entity *entity = new Entity();
+        entity->setSize(5.f + r.randomFloat() * 20.f, 5.f + r.randomFloat() * 20.f, 10);
+        entity->setPosition(r.randomFloat() * 400.f, r.randomFloat() * 400.f, 0);
+        entities.push_back(entity);
+    }
+
+    StaticBroadPhase broadPhase;
+    broadPhase.build(entities);
+    if (broadPhase.getCount() != entities.size())
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Same answers as a linear scan
+    std::vector<Entity *> found, expected;
+    for (int n = 0; n < 500; n++)
+    {
+        Vector3f point(r.randomFloat() * 440.f - 20.f, r.randomFloat() * 440.f - 20.f, 0);
+        Vector3f size(r.randomFloat() * 30.f, r.randomFloat() * 30.f, 10);
+        float radius = r.randomFloat() * 30.f;
+
+        found.clear();
+        expected.clear();
+        broadPhase.queryRect(point, size, found);
+        for (auto &entity : entities)
+        {
+            if (entity->collision(point, size))
+                expected.push_back(entity);
+        }
+        if (!sameEntities(found, expected))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+
+        found.clear();
+        expected.clear();
+        broadPhase.queryRadius(point, radius, found);
+        for (auto &entity : entities)
+        {
+            Vector3f d = entity->getLocalPosition() - point;
+            float reach = radius + entity->getSizeRadius();
+            if (d.x * d.x + d.y * d.y <= reach * reach)
+                expected.push_back(entity);
+        }
+        if (!sameEntities(found, expected))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    // Nothing outside the bounds of every footprint
+    found.clear();
+    broadPhase.queryRect(Vector3f(-1000, -1000, 0), Vector3f(10, 10, 10), found);
+    if (!found.empty())
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (auto &entity : entities)
+    {
+        delete entity;
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <vector>
+
+#include "../include/Camera.hpp"
+#include "../include/WorldConfig.hpp"
+#include "../include/WorldPathfinder.hpp"
+#include "../include/ResourceManager.hpp"
+#include "../include/JobPool.hpp"
+#include "../include/RandomGenerator.hpp"
+
+// The packed walkable rows against the WorldCells' own values
+bool matchesCells(WorldPathfinder &pf)
+{
+    int cols = pf.getCols();
+    int rows = pf.getRows();
+
+    // Ranges crossing and ending on the 64 bit word boundaries
+    int ranges[][2] = {{0, cols}, {0, 64}, {60, 70}, {63, 65}, {64, 128},
+                       {1, 63}, {100, cols}, {-5, 10}, {110, cols + 5}, {30, 30}};
+
+    int values[2] = {1, 2};
+    for (auto value : values)
+    {
+        pf.setValidCellValue(value);
+        for (int j = 0; j < rows; j++)
+        {
+            for (int i = 0; i < cols; i++)
+            {
+                if (pf.validCell(i, j) != (pf.cellValue(i, j) == value))
+                    return false;
+            }
+
+            for (auto &range : ranges)
+            {
+                int start_i = range[0];
+                int end_i = range[1];
+
+                bool free = true;
+                bool hasFree = false;
+                for (int i = start_i; i < end_i; i++)
+                {
+                    bool walkable = pf.validIndex(i, j) && pf.cellValue(i, j) == value;
+                    free = free && walkable;
+                    hasFree = hasFree || walkable;
+                }
+
+                if (pf.rowFree(j, start_i, end_i) != free ||
+                    pf.rowHasFree(j, start_i, end_i) != hasFree)
+                    return false;
+            }
+        }
+    }
+
+    pf.setValidCellValue(1);
+    return true;
+}
+
+int main()
+{
+    std::cout << "# Testing WorldPathfinder walkable bits" << std::endl;
+
+    Camera camera(Vector3f(0, 0, 0), Vector3f(0, 0, 0), Vector2f(64, 32), 10, 800, 600);
+    WorldConfig worldConfig(4000000.f, 4000000.f, 10000, 10000, 40, 40, camera);
+    ResourceManager rm("");
+    JobPool jobPool(1);
+    RandomGenerator r(3);
+
+    // Land, water and obstacles scattered over every cell, so rows have
+    // mixed runs on both sides of each word boundary
+    std::vector<WorldCell *> cells;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            ValueGrid<int> obstacles(worldConfig.subCols(), worldConfig.subRows());
+            for (int ci = 0; ci < obstacles.cols(); ci++)
+            {
+                for (int cj = 0; cj < obstacles.rows(); cj++)
+                {
+                    obstacles.set(ci, cj, r.randomInt(0, 6) == 0 ? 0 : (r.randomInt(0, 3) == 0 ? 2 : 1));
+                }
+            }
+            // A few rows that are entirely one value
+            obstacles.fill(0, 5, obstacles.cols(), 6, 1);
+            obstacles.fill(0, 6, obstacles.cols(), 7, 2);
+
+            WorldCell *cell = new WorldCell(rm, worldConfig, jobPool, i, j);
+            cell->loadObstacles(obstacles);
+            cells.push_back(cell);
+        }
+    }
+
+    WorldPathfinder pf(Vector3f(0, 0, 0), worldConfig);
+    pf.setActiveCells(0, 0, cells);
+
+    if (!matchesCells(pf))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    // Edits on both sides of the word boundary at 64, picked up through
+    // collectChanges
+    cells[1 * 3 + 0]->setObstacle(63 - 40, 5, 0);
+    cells[1 * 3 + 0]->setObstacle(64 - 40, 5, 2);
+    cells[1 * 3 + 1]->setObstacle(0, 10, 1);
+    cells[2 * 3 + 2]->setObstacle(39, 39, 2);
+    for (int ci = 0; ci < 40; ci++)
+        cells[2 * 3 + 1]->setObstacle(ci, 20, 1);
+
+    std::vector<std::pair<int, int>> changes;
+    pf.collectChanges(changes);
+    if (changes.empty() || !matchesCells(pf))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    pf.setValidCellValue(1);
+    if (!pf.rowFree(60, 80, 120) || pf.rowFree(5, 60, 70) || !pf.rowHasFree(5, 62, 65) || pf.rowHasFree(5, 63, 65))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (auto &cell : cells)
+    {
+        delete cell;
+    }
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <vector>
+
+#include "../include/Camera.hpp"
+#include "../include/WorldConfig.hpp"
+#include "../include/WorldPathfinder.hpp"
+#include "../include/ResourceManager.hpp"
+#include "../include/JobPool.hpp"
+#include "../include/RandomGenerator.hpp"
+
+// The cells of the 3x3 window starting at start_i, start_j
+std::vector<WorldCell *> windowCells(std::vector<WorldCell *> &cells, const int &start_i, const int &start_j)
+{
+    std::vector<WorldCell *> window;
+    for (int i = start_i; i < start_i + 3; i++)
+    {
+        for (int j = start_j; j < start_j + 3; j++)
+            window.push_back(cells[i * 4 + j]);
+    }
+    return window;
+}
+
+// A shifted window against one built from scratch
+bool sameGrids(WorldPathfinder &shifted, WorldPathfinder &fresh, RandomGenerator &r)
+{
+    int values[2] = {1, 2};
+    for (auto value : values)
+    {
+        shifted.setValidCellValue(value);
+        fresh.setValidCellValue(value);
+        for (int j = 0; j < fresh.getRows(); j++)
+        {
+            if (!(shifted.rowFree(j, 0, fresh.getCols()) == fresh.rowFree(j, 0, fresh.getCols())))
+                return false;
+
+            for (int i = 0; i < fresh.getCols(); i++)
+            {
+                if (shifted.validCell(i, j) != fresh.validCell(i, j) ||
+                    shifted.clearance(i, j) != fresh.clearance(i, j))
+                    return false;
+            }
+        }
+
+        for (int n = 0; n < 200; n++)
+        {
+            int a_i = r.randomInt(0, fresh.getCols() - 1);
+            int a_j = r.randomInt(0, fresh.getRows() - 1);
+            int b_i = r.randomInt(0, fresh.getCols() - 1);
+            int b_j = r.randomInt(0, fresh.getRows() - 1);
+            if (shifted.sameComponent(a_i, a_j, b_i, b_j) != fresh.sameComponent(a_i, a_j, b_i, b_j))
+                return false;
+        }
+    }
+
+    shifted.setValidCellValue(1);
+    fresh.setValidCellValue(1);
+    return true;
+}
+
+int main()
+{
+    std::cout << "# Testing WorldPathfinder window shifts" << std::endl;
+
+    Camera camera(Vector3f(0, 0, 0), Vector3f(0, 0, 0), Vector2f(64, 32), 10, 800, 600);
+    WorldConfig worldConfig(4000000.f, 4000000.f, 10000, 10000, 40, 40, camera);
+    ResourceManager rm("");
+    JobPool jobPool(1);
+    RandomGenerator r(5);
+
+    // Islands and lagoons spread over 4x4 cells, cell (2, 1) not loaded
+    std::vector<WorldCell *> cells;
+    std::vector<ValueGrid<int>> grids;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            ValueGrid<int> obstacles(worldConfig.subCols(), worldConfig.subRows());
+            obstacles.fill(0, 0, obstacles.cols(), obstacles.rows(), 2);
+            for (int n = 0; n < 6; n++)
+            {
+                int ci = r.randomInt(0, obstacles.cols() - 10);
+                int cj = r.randomInt(0, obstacles.rows() - 10);
+                obstacles.fill(ci, cj, ci + r.randomInt(2, 10), cj + r.randomInt(2, 10), r.randomInt(0, 1));
+            }
+            grids.push_back(obstacles);
+
+            WorldCell *cell = new WorldCell(rm, worldConfig, jobPool, i, j);
+            if (!(i == 2 && j == 1))
+                cell->loadObstacles(obstacles);
+            cells.push_back(cell);
+        }
+    }
+
+    WorldPathfinder shifted(Vector3f(0, 0, 0), worldConfig);
+    shifted.setActiveCells(0, 0, windowCells(cells, 0, 0));
+
+    int moves[][2] = {{1, 0}, {1, 1}, {0, 1}, {0, 0}, {1, 1}, {0, 0}, {0, 1}, {1, 0}};
+    for (auto &move : moves)
+    {
+        shifted.setActiveCells(move[0], move[1], windowCells(cells, move[0], move[1]));
+
+        WorldPathfinder fresh(Vector3f(0, 0, 0), worldConfig);
+        fresh.setActiveCells(move[0], move[1], windowCells(cells, move[0], move[1]));
+
+        if (!sameGrids(shifted, fresh, r))
+        {
+            std::cout << "Failed\n";
+            return 1;
+        }
+    }
+
+    // Loading the missing cell and editing a kept one, then moving on
+    std::vector<std::pair<int, int>> changes;
+    cells[2 * 4 + 1]->loadObstacles(grids[2 * 4 + 1]);
+    cells[1 * 4 + 1]->setObstacle(39, 20, 0);
+    cells[1 * 4 + 1]->setObstacle(0, 0, 1);
+    shifted.collectChanges(changes);
+
+    shifted.setActiveCells(0, 0, windowCells(cells, 0, 0));
+    shifted.collectChanges(changes);
+
+    WorldPathfinder fresh(Vector3f(0, 0, 0), worldConfig);
+    fresh.setActiveCells(0, 0, windowCells(cells, 0, 0));
+    if (!sameGrids(shifted, fresh, r))
+    {
+        std::cout << "Failed\n";
+        return 1;
+    }
+
+    for (auto &cell : cells)
+    {
+        delete cell;
+    }
+
+    return 0;
+}